@@ -25,29 +25,40 @@
  */
 
 #include <algorithm>
+#include <cstdlib>
 #include <iomanip>
 #include "absearch.hpp"
+#include "egdb.hpp"
 #include "nonstdio.hpp"
+#include "stats.hpp"
 
 namespace checkers
 {
+	template <board::player side>
 	int absearch::alpha_beta_search(std::vector<move>& best_moves,
 		unsigned int depth, int alpha, int beta, unsigned int ply)
 	{
 		if (0 == this->_nodes % (2 ^ 16))
 		{
 			nio << io::flush;
-			if (this->is_timeout() || nio.lines_to_read() ||
-				nio.eof())
+			if (this->is_timeout() || (this->_interruptible &&
+				(nio.lines_to_read() || nio.eof())))
 			{
 	 			/// @retval absearch::unknown() when timeout
 				return evaluate::unknown();
 			}
 		}
 		++this->_nodes;
+		stats::add(stats::NODES);
+		if (ply > this->_horizon)
+		{
+			stats::add(stats::QUIESCENCE_NODES);
+		}
 
 		// The default flag type is ALPHA
 		record::hash_flag flag = record::ALPHA;
+		egdb::value result;
+		unsigned int distance;
 		// Try to get the evalute record from the hash table
 		int val = this->probe_hash(depth, alpha, beta, best_moves);
 
@@ -78,19 +89,97 @@ namespace checkers
 				record::EXACT);
 			return -evaluate::win() + ply;
 		}
+		else if (ply > 0 && this->_board.get_occupied().count() <=
+			egdb::get_pieces() && !this->_board.get_jumpers<side>() &&
+			egdb::probe(this->_board, result, distance))
+		{
+			// The databases know the value at the start of a turn,
+			// so the positions in the middle of a jump, which have
+			// jumpers, are searched.  A won position counts as half
+			// a win, less the plies to it and the distance from it
+			// when known, and is not recorded as the value depends
+			// on the ply.
+			best_moves.clear();
+			return egdb::WIN == result ?
+				evaluate::win() / 2 - ply - int(distance) :
+				egdb::LOSS == result ?
+				-evaluate::win() / 2 + ply + int(distance) : 0;
+		}
 		else if (0 == depth)
 		{
+			bool exact;
+
 			best_moves.clear();
-			val = evaluate::evaluate(this->_board);
+			val = this->evaluate_leaf(alpha, beta, exact, ply);
+			if (!exact)
+			{
+				// Only a bound, as in a cutoff.
+				if (val <= alpha)
+				{
+					this->record_hash(depth, alpha,
+						record::ALPHA);
+				}
+				else
+				{
+					this->record_hash(depth, beta,
+						record::BETA);
+				}
+				return val;
+			}
 			this->record_hash(depth, val, record::EXACT);
 			return val;
 		}
 
 		// Generate all the legal moves
-		std::vector<move> legal_moves = this->_board.generate_moves();
+		std::vector<move> legal_moves =
+			this->_board.generate_legal_moves<side>();
+		stats::add(stats::MOVE_GENERATIONS);
+		stats::add(stats::GENERATED_MOVES, legal_moves.size());
 		// Optimize the order of legal moves
 		this->optimize_moves(legal_moves, ply);
 
+		// Extend the hash move when it is far better than all the
+		// alternatives, so forced lines are searched deeper.  Not
+		// past twice the horizon, or a line singular at every node
+		// would never reach depth 0.
+		const record* entry = NULL;
+		bool singular = false;
+		if (depth >= absearch::singular_depth &&
+			ply < 2 * absearch::_horizon &&
+			legal_moves.size() > 1 &&
+			(entry = this->find_hash()) != NULL &&
+			record::EXACT == entry->get_flag() &&
+			entry->get_depth() + 3 >= depth &&
+			!entry->get_best_moves().empty() &&
+			std::abs(entry->get_val()) < evaluate::win() / 2)
+		{
+			const move excluded = entry->get_best_moves().front();
+			const int singular_beta = entry->get_val() -
+				absearch::singular_margin;
+			const long unsigned int nodes = this->_nodes;
+
+			++this->_singular_tests;
+			val = this->exclusion_search<side>(legal_moves,
+				excluded, depth / 2, singular_beta, ply);
+			this->_singular_nodes += this->_nodes - nodes;
+			if (evaluate::unknown() == val)
+			{
+				return val;
+			}
+			if (val < singular_beta)
+			{
+				++this->_singular_extensions;
+				singular = true;
+				std::vector<move>::iterator pos = std::find(
+					legal_moves.begin(), legal_moves.end(),
+					excluded);
+				if (legal_moves.end() != pos)
+				{
+					std::swap(legal_moves[0], *pos);
+				}
+			}
+		}
+
 		std::vector<move> deeper_moves;
 
 		for (std::vector<move>::const_iterator pos =
@@ -102,12 +191,12 @@ namespace checkers
 				++depth;
 			}
 
-			absearch absearch(*this);
-			val = absearch._board.make_move(*pos) ?
-				 absearch.alpha_beta_search(deeper_moves,
-					depth,     alpha,   beta, ply + 1) :
-				-absearch.alpha_beta_search(deeper_moves,
-					depth - 1, -beta, -alpha, ply + 1);
+			// The singular move is searched one ply deeper
+			const unsigned int extension =
+				(singular && legal_moves.begin() == pos) ? 1 : 0;
+
+			val = this->search_move<side>(*pos, deeper_moves,
+				depth + extension, alpha, beta, ply);
 
 			if (evaluate::unknown() == val)
 			{
@@ -115,6 +204,7 @@ namespace checkers
 			}
 			if (val >= beta)
 			{
+				stats::beta_cutoff(pos - legal_moves.begin());
 				this->record_hash(depth, beta, record::BETA);
 				return beta;
 			}
@@ -141,11 +231,76 @@ namespace checkers
 		return alpha;
 	}
 
-	/** @return Timeout or not.
+	/**  The value of a child is checked before it is negated, as the
+	 *   negation of evaluate::unknown() overflows.
+	 *  @return The value of @e a_move for the player on move.
+	 */
+	template <board::player side>
+	int absearch::search_move(const move& a_move,
+		std::vector<move>& best_moves, unsigned int depth, int alpha,
+		int beta, unsigned int ply) const
+	{
+		absearch absearch(*this);
+
+		if (absearch._board.make_move<side>(a_move))
+		{
+			// The same player jumps once more
+			return absearch.alpha_beta_search<side>(best_moves,
+				depth, alpha, beta, ply + 1);
+		}
+
+		const int val = absearch.alpha_beta_search<
+			board::traits<side>::opponent>(best_moves,
+			depth - 1, -beta, -alpha, ply + 1);
+		/// @retval evaluate::unknown() when timeout.
+		return evaluate::unknown() == val ? val : -val;
+	}
+
+	/** @param beta The null window is (beta - 1, beta).
+	 *  @return The best value found, as soon as one reaches @e beta.
+	 */
+	template <board::player side>
+	int absearch::exclusion_search(const std::vector<move>& moves,
+		const move& excluded, unsigned int depth, int beta,
+		unsigned int ply)
+	{
+		std::vector<move> deeper_moves;
+		int best = -evaluate::infinity();
+		int val;
+
+		for (std::vector<move>::const_iterator pos = moves.begin();
+			pos != moves.end(); ++pos)
+		{
+			if (excluded == *pos)
+			{
+				continue;
+			}
+
+			val = this->search_move<side>(*pos, deeper_moves, depth,
+				beta - 1, beta, ply);
+
+			if (evaluate::unknown() == val)
+			{
+				/// @retval evaluate::unknown() when timeout.
+				return val;
+			}
+			best = std::max(best, val);
+			if (best >= beta)
+			{
+				break;
+			}
+		}
+
+		return best;
+	}
+
+	/** @param interruptible Whether pending input or the end of input
+	 *   aborts thinking, as it does while playing.
+	 *  @return Timeout or not.
 	 */ 
 	bool absearch::think(std::vector<move>& best_moves,
 		const board& board, unsigned int depth_limit, time_t time_limit,
-		bool verbose)
+		bool verbose, bool interruptible)
 	{
 		unsigned int i;
 		unsigned int depth;
@@ -154,6 +309,13 @@ namespace checkers
 		struct timeval end;
 
 		absearch::set_timeout(time_limit);
+		absearch::_interruptible = interruptible;
+		absearch::_total_nodes = 0;
+		absearch::_value = 0;
+		absearch::_singular_tests = 0;
+		absearch::_singular_extensions = 0;
+		absearch::_singular_nodes = 0;
+		stats::reset();
 
 		for (i = 0, depth = std::max(best_moves.size(),
 			static_cast<std::vector<move>::size_type>(1U)), val = 0;
@@ -163,12 +325,23 @@ namespace checkers
 			absearch::_nodes = 0;
 			absearch::_best_moves = best_moves;
 			absearch::_optimize_move = true;
+			absearch::_horizon = depth;
 
 			absearch absearch(board);
 			start = timeval::now();
-			val = absearch.alpha_beta_search(best_moves,
-				depth);
+			val = board.is_black_to_move() ?
+				absearch.alpha_beta_search<board::BLACK>(
+					best_moves, depth) :
+				absearch.alpha_beta_search<board::WHITE>(
+					best_moves, depth);
 			end = timeval::now();
+			absearch::_total_nodes += absearch::_nodes;
+			if (evaluate::unknown() != val)
+			{
+				absearch::_value = val;
+			}
+			stats::iteration(depth, evaluate::unknown() == val ?
+				0 : absearch::_nodes, end - start);
 
 			if (verbose)
 			{
@@ -183,6 +356,16 @@ namespace checkers
 			}
 		}
 
+		if (verbose && absearch::_singular_tests)
+		{
+			nio << "  singular extensions " <<
+				absearch::_singular_extensions << '/' <<
+				absearch::_singular_tests << ", " <<
+				absearch::_singular_nodes << " of " <<
+				absearch::_total_nodes <<
+				" nodes in exclusion searches\n";
+		}
+
 		/** @retval true while timeout.
 		 *  @retval false while reach specified search depth or game
 		 *   end.
@@ -190,6 +373,36 @@ namespace checkers
 		return val == evaluate::unknown();
 	}
 
+	void absearch::clear_hash(void)
+	{
+		std::fill(absearch::_hash.begin(), absearch::_hash.end(),
+			record());
+		std::fill(absearch::_eval_cache.begin(),
+			absearch::_eval_cache.end(), 0);
+	}
+
+	/** @param megabytes The size is rounded down to a power of 2
+	 *   entries.
+	 */
+	void absearch::set_eval_cache_size(unsigned int megabytes)
+	{
+		std::vector<uint64_t>::size_type size = 1;
+		const std::vector<uint64_t>::size_type limit =
+			std::vector<uint64_t>::size_type(megabytes) * 1024 *
+			1024 / sizeof(uint64_t);
+
+		if (0 == megabytes)
+		{
+			std::vector<uint64_t>().swap(absearch::_eval_cache);
+			return;
+		}
+		while (size * 2 <= limit)
+		{
+			size *= 2;
+		}
+		std::vector<uint64_t>(size).swap(absearch::_eval_cache);
+	}
+
 	// ================================================================
 
 	std::string absearch::thinking_detail(unsigned int depth, int val,
@@ -262,6 +475,57 @@ namespace checkers
 		std::swap(moves[0], *pos);
 	}
 
+	/**  The value only depends on the position, so an entry never
+	 *   goes stale.  An empty entry is 0, which no position with a
+	 *   nonzero high half of the key can match.  Only exact values are
+	 *   stored.
+	 */
+	int absearch::evaluate_leaf(int alpha, int beta, bool& exact,
+		unsigned int ply) const
+	{
+		const uint64_t key = this->_board.get_zobrist().key();
+		uint64_t* entry = NULL;
+
+		if (!absearch::_eval_cache.empty())
+		{
+			entry = &absearch::_eval_cache[key &
+				(absearch::_eval_cache.size() - 1)];
+			stats::add(stats::EVAL_CACHE_PROBES);
+			if (0 != *entry && 0 == ((*entry ^ key) >> 32))
+			{
+				stats::add(stats::EVAL_CACHE_HITS);
+				exact = true;
+				return int32_t(uint32_t(*entry));
+			}
+		}
+
+		const int val = evaluate::lazy(this->_board, alpha, beta,
+			exact, ply);
+
+		stats::add(stats::EVALUATIONS);
+		if (!exact)
+		{
+			stats::add(stats::LAZY_EXITS);
+		}
+		else if (NULL != entry)
+		{
+			*entry = (key & ~uint64_t(0xffffffffU)) | uint32_t(val);
+		}
+		return val;
+	}
+
+	/** @return The record of the current board, or NULL if there is no
+	 *   record for it in the hash table.
+	 */
+	const record* absearch::find_hash(void) const
+	{
+		const record& entry = absearch::_hash[
+			this->_board.get_zobrist().key() % absearch::hash_size];
+
+		return entry.get_zobrist() == this->_board.get_zobrist() ?
+			&entry : NULL;
+	}
+
 	/** @param depth
 	 *  @param alpha
 	 *  @param beta
@@ -275,9 +539,17 @@ namespace checkers
 			+ (this->_board.get_zobrist().key()
 			% absearch::hash_size);
 
+		stats::add(stats::HASH_PROBES);
 		if (pos->get_zobrist() == this->_board.get_zobrist())
 		{
-			return pos->get_val(depth, alpha, beta, best_moves);
+			stats::add(stats::HASH_HITS);
+			const int val = pos->get_val(depth, alpha, beta,
+				best_moves);
+			if (evaluate::unknown() != val)
+			{
+				stats::add(stats::HASH_CUTOFFS);
+			}
+			return val;
 		}
 		/** @retval evaluate::unknown() while an effective value is not
 		 *   found in the hash table.
@@ -292,6 +564,12 @@ namespace checkers
 			+ (this->_board.get_zobrist().key()
 			% absearch::hash_size);
 
+		stats::add(stats::HASH_STORES);
+		if (pos->get_zobrist() != this->_board.get_zobrist() &&
+			pos->get_zobrist() != zobrist())
+		{
+			stats::add(stats::HASH_OVERWRITES);
+		}
 		*pos = record(this->_board.get_zobrist(), depth, val, flag);
 	}
 
@@ -302,6 +580,12 @@ namespace checkers
 			+ (this->_board.get_zobrist().key()
 			% absearch::hash_size);
 
+		stats::add(stats::HASH_STORES);
+		if (pos->get_zobrist() != this->_board.get_zobrist() &&
+			pos->get_zobrist() != zobrist())
+		{
+			stats::add(stats::HASH_OVERWRITES);
+		}
 		*pos = record(this->_board.get_zobrist(), depth, val, flag,
 			best_moves);
 	}
@@ -309,8 +593,17 @@ namespace checkers
 	std::vector<move> absearch::_best_moves;
 	bool absearch::_optimize_move = false;
 	long unsigned int absearch::_nodes = 0;
+	long unsigned int absearch::_total_nodes = 0;
+	int absearch::_value = 0;
+	bool absearch::_interruptible = true;
+	unsigned int absearch::_horizon = 0;
+	long unsigned int absearch::_singular_tests = 0;
+	long unsigned int absearch::_singular_extensions = 0;
+	long unsigned int absearch::_singular_nodes = 0;
 	struct timeval absearch::_deadline = { 0, 0 };
 	std::vector<record> absearch::_hash(absearch::hash_size);
+	std::vector<uint64_t> absearch::_eval_cache(
+		absearch::eval_cache_size * 1024 * 1024 / sizeof(uint64_t));
 }
 
 // End of file
@@ -39,9 +39,31 @@ namespace checkers
 		typedef bool (*ponder_t)(void);
 		static bool think(std::vector<move>& best_moves,
 			const board& board, unsigned int depth_limit,
-			time_t second, bool verbose = false);
+			time_t second, bool verbose = false,
+			bool interruptible = true);
+
+		/// Forget everything in the hash table and evaluation cache.
+		static void clear_hash(void);
+		/** @brief Set the size of the evaluation cache in megabytes,
+		 *   0 to evaluate every leaf.
+		 */
+		static void set_eval_cache_size(unsigned int megabytes);
+		/// Number of nodes searched by the last think.
+		inline static long unsigned int get_nodes(void);
+		/** @brief Value of the last think for the player to move, by
+		 *   the deepest iteration finished.
+		 */
+		inline static int get_value(void);
 
 		static const unsigned int hash_size = 1024 * 1024;
+		/// Default size of the evaluation cache in megabytes.
+		static const unsigned int eval_cache_size = 0;
+		/// Minimum remaining depth to try a singular extension.
+		static const unsigned int singular_depth = 6;
+		/** @brief How much the hash move has to be better than all the
+		 *   alternatives to be extended.
+		 */
+		static const int singular_margin = 64;
 
 	private:
 		inline explicit absearch(const board& board);
@@ -49,14 +71,30 @@ namespace checkers
 		/** @brief Alpha-beta pruning is a search algorithm that
 		 *   reduces the number of nodes that need to be evaluated
 		 *   in the search tree by the minimax algorithm.
-		 *  @note This is recursive function.
+		 *  @note This is recursive function, instantiated for the
+		 *   player @e side on move.
 		 */
+		template <board::player side>
 		int alpha_beta_search(std::vector<move>& best_moves,
 			unsigned int depth,
 			int alpha = -evaluate::infinity(),
 			int beta = evaluate::infinity(),
 			unsigned int ply = 0);
 
+		/// Make @e a_move and search the child node.
+		template <board::player side>
+		int search_move(const move& a_move,
+			std::vector<move>& best_moves, unsigned int depth,
+			int alpha, int beta, unsigned int ply) const;
+
+		/** @brief Null window search of all the moves except
+		 *   @e excluded, to check whether @e excluded is singular.
+		 */
+		template <board::player side>
+		int exclusion_search(const std::vector<move>& moves,
+			const move& excluded, unsigned int depth, int beta,
+			unsigned int ply);
+
 		/// The detail information of thinking.
 		static std::string thinking_detail(unsigned int depth, int val,
 			struct timeval time, long unsigned int nodes,
@@ -64,9 +102,17 @@ namespace checkers
 
 		void optimize_moves(std::vector<move>& moves, unsigned int ply);
 
+		/** @brief Evaluate the board through the evaluation cache,
+		 *   lazily for the window (@e alpha, @e beta).
+		 */
+		int evaluate_leaf(int alpha, int beta, bool& exact,
+			unsigned int ply) const;
+
 		inline static void set_timeout(time_t second);
 		inline static bool is_timeout(void);
 
+		/// Find the record of the current board in the hash table.
+		const record* find_hash(void) const;
 		/// Get an evaluate value from the hash table.
 		int probe_hash(unsigned int depth, int alpha, int beta,
 			std::vector<move>& best_moves) const;
@@ -84,9 +130,23 @@ namespace checkers
 		static bool _optimize_move;
 
 		static long unsigned int _nodes;
+		/// Nodes of all the iterations of the last think.
+		static long unsigned int _total_nodes;
+		static int _value;
+		/// Whether pending input aborts the search.
+		static bool _interruptible;
+		/// The nominal depth of the current iteration.
+		static unsigned int _horizon;
+		static long unsigned int _singular_tests;
+		static long unsigned int _singular_extensions;
+		static long unsigned int _singular_nodes;
 		static struct timeval _deadline;
 
 		static std::vector<record> _hash;
+		/** @brief Direct-mapped cache of evaluations, the high 32 bits
+		 *   of the key and the value in the low 32 bits.
+		 */
+		static std::vector<uint64_t> _eval_cache;
 	};
 }
 
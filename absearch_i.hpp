@@ -36,6 +36,19 @@ namespace checkers
 	{
 	}
 
+	/** @return Nodes searched by all the iterations of the last
+	 *   think, finished or not.
+	 */
+	inline long unsigned int absearch::get_nodes(void)
+	{
+		return absearch::_total_nodes;
+	}
+
+	inline int absearch::get_value(void)
+	{
+		return absearch::_value;
+	}
+
 	// ================================================================
 
 	inline void absearch::set_timeout(time_t second)
@@ -0,0 +1,743 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file bench.cpp
+ *  @brief Reproducible benchmark.
+ */
+
+extern "C"
+{
+	#include <sys/types.h>
+	#include <sys/wait.h>
+	#include <unistd.h>
+}
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include "absearch.hpp"
+#include "bench.hpp"
+#include "dataset.hpp"
+#include "evaluate.hpp"
+#include "nnue.hpp"
+#include "nonstdio.hpp"
+#include "packed.hpp"
+
+namespace checkers
+{
+	namespace bench
+	{
+		const char* const positions[] =
+		{
+			// Openings
+			"B:W21,22,23,24,25,26,27,28,29,30,31,32:"
+				"B1,2,3,4,5,6,7,8,9,10,11,12",
+			"W:W18,21,24,25,26,27,28,29,30,31,32:"
+				"B1,2,3,4,7,8,9,10,11,13,16",
+			"W:W17,20,22,25,26,27,28,29,30,31,32:"
+				"B1,2,3,4,5,6,7,9,10,11,19",
+			"B:W17,21,23,24,25,27,28,29,30,31,32:"
+				"B1,2,3,4,5,6,7,8,9,10,12",
+			"B:W17,20,21,22,23,25,28,29,30,31,32:"
+				"B1,2,3,4,5,7,8,9,10,12,14",
+			"W:W19,21,25,26,27,28,29,30,31,32:"
+				"B1,2,3,4,5,6,7,8,12,18",
+			"W:W20,21,22,23,24,25,26,28,29,30,31,32:"
+				"B1,2,4,5,6,7,8,9,10,11,12,16",
+			"W:W17,22,23,25,26,27,28,29,30,31,32:"
+				"B1,2,3,4,5,7,9,11,12,15,16",
+			"B:W19,21,23,25,26,27,28,29,30,31,32:"
+				"B1,2,3,4,5,6,8,9,12,14,16",
+			"W:W12,21,22,24,25,27,28,29,30,31,32:"
+				"B1,2,3,4,5,7,8,9,10,11",
+			"W:W21,22,23,25,26,27,28,29,30,31,32:"
+				"B1,2,3,4,5,6,7,8,12,13,14,20",
+			"B:W19,20,21,22,25,26,27,29,30,31,32:"
+				"B1,2,3,4,5,6,7,8,10,12,13",
+			"B:W12,21,22,23,25,26,27,28,29,30,31,32:"
+				"B1,2,3,4,5,6,7,8,10,11,13",
+			"W:W18,23,24,25,26,27,28,29,30,31,32:"
+				"B1,2,3,4,5,6,7,8,11,12,17",
+			"B:W20,21,22,25,26,27,28,29,30,31,32:"
+				"B1,2,3,4,6,7,8,11,12,13,14",
+			"W:W21,22,24,25,26,28,29,30,31,32:"
+				"B1,2,3,4,5,6,7,10,12,15",
+			// Middlegames
+			"B:W17,23,27,28,29,31:B1,2,3,4,5,6,7,12,K30",
+			"B:W13,23,25,27,28,29,31:B1,4,5,7,8,11,15",
+			"B:W14,23,28,29,31,32:B1,2,3,4,5,7,22",
+			"B:W17,18,24,28,29,30,31:B3,4,6,7,8,9,12,16",
+			"W:W12,13,24,26,28,29,30:B2,3,4,10,19",
+			"B:W13,19,20,22,26,28,29,30,31:B1,2,3,6,7,8,11,12,21",
+			"B:W5,22,25,26,27,28,29,32:B1,2,4,7,9,13,15,21",
+			"B:W17,18,19,25,29,30,31,32:B1,2,3,5,7,8,9,12,21",
+			"W:W17,21,22,29,31:B1,2,3,5,10,11,28",
+			"B:W16,18,23,29,31:B1,2,3,4,6,9,11,28",
+			"B:W17,20,21,23,25,26,28,32:B1,2,3,6,8,9,12,14",
+			"B:W15,23,24,25,28,29,30,32:B1,2,3,4,7,8,12,21",
+			"W:W18,22,27,30,32:B2,4,7,11,12,16,28",
+			"B:W17,20,23,25,29,30,31,32:B2,3,4,6,7,8,9,11,19,24",
+			"B:W12,23,24,27,28,31:B1,3,4,6,8,9,14,K25",
+			"W:W18,21,28,29,30,31:B1,3,4,5,9,22",
+			"B:W17,21,23,28,29,30,31,K3:B4,5,6,8,12,16",
+			"W:W18,21,23,25,27,30,32:B2,4,5,7,9,11,12",
+			// Endgames
+			"B:W7,17,K18,K22:BK24",
+			"W:W32,K30:BK15,K18",
+			"W:W15,29,K11:B1,8,K4,K23,K30",
+			"W:W26,29,K9,K10:B8,K2,K16,K27",
+			"B:W17,21,K14,K30:B7,K2,K10",
+			"B:WK20:B13,19,K2,K23",
+			"W:W10,17,K6,K13:BK16,K22,K28",
+			"B:W10,K8,K13,K27:BK5",
+			"B:W20,27,K8,K17,K31:BK18",
+			"W:WK25:BK1,K5,K31",
+			"W:WK5:BK10,K17",
+			"B:W18,K20:B12,K4,K19,K31",
+			"W:W12,K27:B7,13,K22,K30",
+			"W:W28,K5,K15,K16:BK7,K14",
+			"W:WK7,K18,K26:B17,24,K4,K21,K27",
+			"B:W11,K16:BK3,K18,K23"
+		};
+		const unsigned int positions_size =
+			sizeof(positions) / sizeof(positions[0]);
+
+		namespace
+		{
+			/// Time limit, long enough to always reach the depth.
+			const time_t NO_TIME_LIMIT = 999999;
+
+			/// Result of searching one position.
+			struct result
+			{
+				unsigned int index;
+				long unsigned int nodes;
+				struct timeval time;
+			};
+
+			/** @brief Search a position of the suite from an empty
+			 *   hash table, so the node count only depends on the
+			 *   position and the depth.
+			 */
+			result search_position(unsigned int index,
+				unsigned int depth)
+			{
+				std::vector<move> best_moves;
+				result result;
+
+				absearch::clear_hash();
+				result.index = index;
+				result.time = timeval::now();
+				absearch::think(best_moves, board(positions[index]),
+					depth, NO_TIME_LIMIT, false, false);
+				result.time = timeval::now() - result.time;
+				result.nodes = absearch::get_nodes();
+
+				return result;
+			}
+
+			/// Search every @e workers th position from @e first.
+			void worker(int fd, unsigned int first, unsigned int workers,
+				unsigned int depth)
+			{
+				try
+				{
+					for (unsigned int i = first; i < positions_size;
+						i += workers)
+					{
+						const result result =
+							search_position(i, depth);
+						if (write(fd, &result, sizeof(result)) !=
+							sizeof(result))
+						{
+							_exit(1);
+						}
+					}
+				}
+				catch (...)
+				{
+					_exit(1);
+				}
+				_exit(0);
+			}
+
+			/** @return Whether a whole result has been read, false at
+			 *   the end of file.
+			 */
+			bool read_result(int fd, result& result)
+			{
+				char* buffer = reinterpret_cast<char*>(&result);
+				size_t done = 0;
+
+				while (done < sizeof(result))
+				{
+					const ssize_t size = read(fd, buffer + done,
+						sizeof(result) - done);
+					if (size < 0 && EINTR == errno)
+					{
+						continue;
+					}
+					if (size < 0)
+					{
+						/// @throw std::runtime_error when read()
+						///  failed.
+						throw std::runtime_error(
+							std::string("read() failed: ") +
+							std::strerror(errno));
+					}
+					if (0 == size)
+					{
+						return false;
+					}
+					done += size;
+				}
+				return true;
+			}
+
+			/** @brief Fork @e workers processes, each with its own
+			 *   hash table, and collect their results.
+			 */
+			void search_parallel(std::vector<result>& results,
+				unsigned int depth, unsigned int workers)
+			{
+				std::vector<int> fds;
+				std::vector<pid_t> pids;
+				unsigned int i;
+
+				// Nothing buffered may be written twice by the
+				// children.
+				nio << io::flush;
+				for (i = 0; i < workers; ++i)
+				{
+					int fd[2];
+					pid_t pid;
+
+					if (pipe(fd) < 0)
+					{
+						/// @throw std::runtime_error when pipe()
+						///  failed.
+						throw std::runtime_error(
+							std::string("pipe() failed: ") +
+							std::strerror(errno));
+					}
+					if ((pid = fork()) < 0)
+					{
+						/// @throw std::runtime_error when fork()
+						///  failed.
+						throw std::runtime_error(
+							std::string("fork() failed: ") +
+							std::strerror(errno));
+					}
+					else if (0 == pid)
+					{
+						// Child
+						close(fd[0]);
+						for (std::vector<int>::size_type j = 0;
+							j < fds.size(); ++j)
+						{
+							close(fds[j]);
+						}
+						worker(fd[1], i, workers, depth);
+					}
+					close(fd[1]);
+					fds.push_back(fd[0]);
+					pids.push_back(pid);
+				}
+
+				unsigned int count = 0;
+				for (i = 0; i < workers; ++i)
+				{
+					result result;
+					while (read_result(fds[i], result))
+					{
+						results[result.index] = result;
+						++count;
+					}
+					close(fds[i]);
+				}
+				for (i = 0; i < workers; ++i)
+				{
+					while (waitpid(pids[i], NULL, 0) < 0 &&
+						EINTR == errno)
+					{
+					}
+				}
+				if (count != positions_size)
+				{
+					/// @throw std::runtime_error when a worker
+					///  died.
+					throw std::runtime_error(
+						"bench worker terminated abnormally");
+				}
+			}
+
+			/// The positions of the suite and their children.
+			std::vector<board> evaluation_boards(void)
+			{
+				std::vector<board> boards;
+
+				for (unsigned int i = 0; i < positions_size; ++i)
+				{
+					const board board(positions[i]);
+					const std::vector<move> moves =
+						board.generate_moves();
+
+					boards.push_back(board);
+					for (std::vector<move>::const_iterator pos =
+						moves.begin(); pos != moves.end();
+						++pos)
+					{
+						boards.push_back(board);
+						boards.back().make_move(*pos);
+					}
+				}
+				return boards;
+			}
+
+			/** @brief Evaluate by the network from the accumulator
+			 *   of a ply, which the siblings share.
+			 */
+			int evaluate_ply(const board& board)
+			{
+				return nnue::evaluate(board, 1);
+			}
+
+			/** @brief Evaluate @e boards @e rounds times by
+			 *   @e evaluate.
+			 *  @param checksum The sum of the values of a round.
+			 *  @return The time taken.
+			 */
+			struct timeval time_evaluation(
+				const std::vector<board>& boards,
+				unsigned int rounds,
+				int (*evaluate)(const board& board),
+				long int& checksum)
+			{
+				std::vector<board>::size_type i;
+				long int sum = 0;
+
+				checksum = 0;
+				for (i = 0; i < boards.size(); ++i)
+				{
+					checksum += evaluate(boards[i]);
+				}
+
+				struct timeval time = timeval::now();
+				for (unsigned int round = 0; round < rounds;
+					++round)
+				{
+					for (i = 0; i < boards.size(); ++i)
+					{
+						// A copy does not keep the movers
+						// cached by the last round.
+						const board board(boards[i]);
+						sum += evaluate(board);
+					}
+				}
+				time = timeval::now() - time;
+
+				// The sum keeps the evaluations from being
+				// optimized away.
+				if (sum != checksum * long(rounds))
+				{
+					/// @throw std::logic_error when the
+					///  evaluation is not deterministic.
+					throw std::logic_error(
+						"evaluation is not deterministic");
+				}
+				return time;
+			}
+
+			/// Rate of @e count in @e time.
+			long int per_second(double count,
+				const struct timeval& time)
+			{
+				const double elapsed = time.tv_sec +
+					time.tv_usec / 1e6;
+
+				return long(elapsed > 0 ? count / elapsed : 0.0);
+			}
+
+			/// Seconds of @e time, with milliseconds.
+			std::string seconds(const struct timeval& time)
+			{
+				std::ostringstream stream;
+
+				stream << time.tv_sec << '.' << std::setw(3) <<
+					std::setfill('0') << (time.tv_usec / 1000);
+				return stream.str();
+			}
+
+			/** @brief Add a position to @e checksum, in any order of
+			 *   the positions.
+			 */
+			inline void mix(unsigned long int& checksum, uint32_t black,
+				uint32_t white, uint32_t kings, bool black_to_move)
+			{
+				checksum += (black * 0x9e3779b1UL) ^
+					(white * 0x85ebca6bUL) ^ (kings * 0xc2b2ae35UL) ^
+					(black_to_move ? 1 : 0);
+			}
+		}
+
+		/** @param depth Search depth of every position.
+		 *  @param workers Number of processes to search in parallel.
+		 *   The node count does not depend on it.
+		 *  @return The report, one line per position and the total
+		 *   nodes, time and speed.  The time is of the whole benchmark,
+		 *   the speed is by the times of the searches, of all the
+		 *   workers together.  The total nodes of a depth is a
+		 *   signature of the search: it only changes along with the
+		 *   behavior of the search.
+		 */
+		std::string search(unsigned int depth, unsigned int workers)
+		{
+			std::vector<result> results(positions_size);
+			std::ostringstream stream;
+			long unsigned int nodes = 0;
+			unsigned int i;
+
+			if (workers < 1)
+			{
+				workers = 1;
+			}
+			else if (workers > MAX_WORKERS)
+			{
+				workers = MAX_WORKERS;
+			}
+
+			struct timeval time = timeval::now();
+			if (1 == workers)
+			{
+				for (i = 0; i < positions_size; ++i)
+				{
+					results[i] = search_position(i, depth);
+				}
+			}
+			else
+			{
+				search_parallel(results, depth, workers);
+			}
+			time = timeval::now() - time;
+
+			// The speed is of the searches only, without clearing
+			// the hash table before each, which takes as long as a
+			// shallow search.
+			double searching = 0.0;
+			stream << "  position       nodes      time\n"
+				"  ------------------------------\n";
+			for (i = 0; i < positions_size; ++i)
+			{
+				nodes += results[i].nodes;
+				searching += results[i].time.tv_sec +
+					results[i].time.tv_usec / 1e6;
+				stream << "  " << std::setw(8) << (i + 1) <<
+					std::setw(12) << results[i].nodes <<
+					std::setw(10) <<
+					seconds(results[i].time) << '\n';
+			}
+
+			stream << "  ==============================\n"
+				"  depth        " << std::setw(16) << depth << "\n"
+				"  workers      " << std::setw(16) << workers << "\n"
+				"  nodes        " << std::setw(16) << nodes << "\n"
+				"  time         " << std::setw(16) << seconds(time) <<
+				"\n"
+				"  nodes/second " << std::setw(16) <<
+				long(searching > 0 ? nodes / searching * workers :
+				0.0) << '\n';
+
+			return stream.str();
+		}
+
+		/** @param rounds Times to evaluate every position.
+		 *  @return The report of the number of evaluations, time and
+		 *   speed.  The checksum is the sum of all the values of a
+		 *   round, it only changes along with the evaluation.
+		 */
+		std::string evaluation(unsigned int rounds)
+		{
+			const std::vector<board> boards = evaluation_boards();
+			std::ostringstream stream;
+			long int checksum = 0;
+			const struct timeval time = time_evaluation(boards,
+				rounds, &evaluate::evaluate, checksum);
+
+			const double evaluations = double(boards.size()) * rounds;
+			stream << "  positions    " << std::setw(16) <<
+				boards.size() << "\n"
+				"  evaluations  " << std::setw(16) <<
+				long(evaluations) << "\n"
+				"  time         " << std::setw(16) << seconds(time) <<
+				"\n"
+				"  evals/second " << std::setw(16) <<
+				per_second(evaluations, time) << "\n"
+				"  checksum     " << std::setw(16) << checksum <<
+				'\n';
+
+			return stream.str();
+		}
+
+		/** @param rounds Times to evaluate every position.
+		 *  @return The report of the speed of the linear evaluation,
+		 *   the network with the accumulator of a ply updated from
+		 *   board to board as in a search, and the network in plain
+		 *   C++ from scratch.
+		 */
+		std::string network(unsigned int rounds)
+		{
+			const std::vector<board> boards = evaluation_boards();
+			std::ostringstream stream;
+			long int checksums[3] = { 0, 0, 0 };
+			const struct timeval times[3] =
+			{
+				time_evaluation(boards, rounds, &evaluate::linear,
+					checksums[0]),
+				time_evaluation(boards, rounds, &evaluate_ply,
+					checksums[1]),
+				time_evaluation(boards, rounds,
+					&nnue::evaluate_scalar, checksums[2])
+			};
+			const char* const names[3] =
+			{
+				"linear       ", "network      ", "scalar       "
+			};
+
+			const double evaluations = double(boards.size()) * rounds;
+			stream << "  positions    " << std::setw(16) <<
+				boards.size() << "\n"
+				"  evaluations  " << std::setw(16) <<
+				long(evaluations) << "\n"
+				"               evals/second      time  checksum\n";
+			for (unsigned int i = 0; i < 3; ++i)
+			{
+				stream << "  " << names[i] << std::setw(16) <<
+					per_second(evaluations, times[i]) <<
+					std::setw(10) << seconds(times[i]) <<
+					std::setw(10) << checksums[i] << '\n';
+			}
+
+			return stream.str();
+		}
+
+		/** @param rounds Times to evaluate every position.
+		 *  @return The report of the speed of evaluate_batch() from
+		 *   the boards and from arrays of bitboards, and of its
+		 *   reference one position at a time.
+		 */
+		std::string batch(unsigned int rounds)
+		{
+			const std::vector<board> boards = evaluation_boards();
+			const std::vector<board>::size_type size = boards.size();
+			std::vector<uint32_t> black(size);
+			std::vector<uint32_t> white(size);
+			std::vector<uint32_t> kings(size);
+			std::vector<int32_t> players(size);
+			std::vector<int> values[3];
+			std::ostringstream stream;
+			const char* const names[3] =
+			{
+				"boards       ", "arrays       ", "scalar       "
+			};
+
+			for (std::vector<board>::size_type i = 0; i < size; ++i)
+			{
+				black[i] = boards[i].get_black_pieces().bits();
+				white[i] = boards[i].get_white_pieces().bits();
+				kings[i] = boards[i].get_kings().bits();
+				players[i] = boards[i].is_black_to_move() ?
+					board::BLACK : board::WHITE;
+			}
+
+			const double evaluations = double(size) * rounds;
+			stream << "  positions    " << std::setw(16) << size <<
+				"\n"
+				"  evaluations  " << std::setw(16) <<
+				long(evaluations) << "\n"
+				"               evals/second      time  checksum\n";
+			for (unsigned int i = 0; i < 3; ++i)
+			{
+				long int checksum = 0;
+
+				values[i].resize(size);
+				int* const out = &values[i][0];
+
+				struct timeval time = timeval::now();
+				for (unsigned int round = 0; round < rounds;
+					++round)
+				{
+					if (0 == i)
+					{
+						evaluate::evaluate_batch(&boards[0],
+							size, out);
+					}
+					else if (1 == i)
+					{
+						evaluate::evaluate_batch(&black[0],
+							&white[0], &kings[0],
+							&players[0], size, out);
+					}
+					else
+					{
+						evaluate::evaluate_batch_scalar(
+							&boards[0], size, out);
+					}
+				}
+				time = timeval::now() - time;
+
+				for (std::vector<board>::size_type j = 0; j < size;
+					++j)
+				{
+					checksum += out[j];
+				}
+				stream << "  " << names[i] << std::setw(16) <<
+					per_second(evaluations, time) <<
+					std::setw(10) << seconds(time) <<
+					std::setw(10) << checksum << '\n';
+			}
+			if (values[0] != values[2] || values[1] != values[2])
+			{
+				/// @throw std::logic_error when the batch
+				///  evaluation differs from the reference.
+				throw std::logic_error(
+					"batch evaluation differs from the reference");
+			}
+
+			return stream.str();
+		}
+
+		/** @param filename A dataset of lines of FEN or games in PDN.
+		 *  @return The report of the speed of reading @e filename by
+		 *   dataset, for lines of FEN also by board::board(const
+		 *   std::string&) from a line of a stream at a time, and for a
+		 *   packed dataset also by index in a scattered order.
+		 */
+		std::string reader(const std::string& filename)
+		{
+			std::ostringstream stream;
+			unsigned long int checksum = 0;
+			long int positions = 0;
+			bool is_pdn;
+			bool is_packed;
+			size_t errors;
+
+			struct timeval time = timeval::now();
+			{
+				dataset data(filename);
+				dataset::sample sample;
+
+				while (data.next(sample))
+				{
+					mix(checksum, sample.black, sample.white,
+						sample.kings, sample.black_to_move);
+					++positions;
+				}
+				is_pdn = data.is_pdn();
+				is_packed = data.is_packed();
+				errors = data.get_errors().size();
+			}
+			time = timeval::now() - time;
+
+			stream << "  format       " << std::setw(16) <<
+				(is_packed ? "packed" : is_pdn ? "PDN" : "FEN") <<
+				"\n"
+				"  positions    " << std::setw(16) << positions << "\n"
+				"  errors       " << std::setw(16) << errors << "\n"
+				"               positions/second      time  checksum\n"
+				"  dataset      " << std::setw(16) <<
+				per_second(double(positions), time) <<
+				std::setw(10) << seconds(time) << std::setw(10) <<
+				(checksum & 0xffffffUL) << '\n';
+			if (is_packed)
+			{
+				const packed data(filename);
+				const uint64_t size = data.size();
+				// A prime step visits every record once.
+				const uint64_t step = size % 1000003 ? 1000003 : 1;
+				uint64_t index = 0;
+
+				checksum = 0;
+				time = timeval::now();
+				for (uint64_t i = 0; i < size; ++i)
+				{
+					const packed::record& record = data[index];
+
+					mix(checksum, record.black, record.white,
+						record.kings, record.black_to_move);
+					index = (index + step) % size;
+				}
+				time = timeval::now() - time;
+
+				stream << "  random       " << std::setw(16) <<
+					per_second(double(size), time) <<
+					std::setw(10) << seconds(time) <<
+					std::setw(10) << (checksum & 0xffffffUL) <<
+					'\n';
+			}
+			if (is_pdn || is_packed)
+			{
+				return stream.str();
+			}
+
+			std::ifstream file(filename.c_str());
+			std::string line;
+
+			checksum = 0;
+			positions = 0;
+			time = timeval::now();
+			while (std::getline(file, line))
+			{
+				std::istringstream words(line);
+				std::string fen;
+
+				if (!(words >> fen) || '#' == fen[0])
+				{
+					continue;
+				}
+				try
+				{
+					const board board(fen);
+
+					mix(checksum, board.get_black_pieces().bits(),
+						board.get_white_pieces().bits(),
+						board.get_kings().bits(),
+						board.is_black_to_move());
+					++positions;
+				}
+				catch (const std::logic_error&)
+				{
+				}
+			}
+			time = timeval::now() - time;
+
+			stream << "  strings      " << std::setw(16) <<
+				per_second(double(positions), time) <<
+				std::setw(10) << seconds(time) << std::setw(10) <<
+				(checksum & 0xffffffUL) << '\n';
+			return stream.str();
+		}
+	}
+}
+
+// End of file
@@ -0,0 +1,77 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file bench.hpp
+ *  @brief Reproducible benchmark.
+ */
+
+#ifndef __BENCH_HPP__
+#define __BENCH_HPP__
+
+#include <string>
+
+namespace checkers
+{
+	/** @brief Reproducible benchmark over a built-in suite of
+	 *   positions.
+	 */
+	namespace bench
+	{
+		/// Default search depth of the benchmark.
+		const unsigned int DEFAULT_DEPTH = 10;
+		/// Maximum number of worker processes.
+		const unsigned int MAX_WORKERS = 64;
+		/// Default rounds of the evaluation benchmark.
+		const unsigned int DEFAULT_ROUNDS = 100000;
+
+		/** @brief Search every position of the suite to @e depth,
+		 *   spread over @e workers processes.
+		 */
+		std::string search(unsigned int depth, unsigned int workers);
+		/** @brief Evaluate the positions of the suite and their
+		 *   children @e rounds times.
+		 */
+		std::string evaluation(unsigned int rounds);
+		/** @brief Evaluate the positions of the suite and their
+		 *   children @e rounds times by the linear evaluation and by
+		 *   the network.
+		 */
+		std::string network(unsigned int rounds);
+		/** @brief Evaluate the positions of the suite and their
+		 *   children @e rounds times by evaluate::evaluate_batch()
+		 *   and by its reference.
+		 */
+		std::string batch(unsigned int rounds);
+		/** @brief Read the positions of the dataset @e filename, by
+		 *   dataset and by the FEN strings.
+		 */
+		std::string reader(const std::string& filename);
+
+		/// The suite: openings, middlegames and king endgames in FEN.
+		extern const char* const positions[];
+		/// Number of positions in the suite.
+		extern const unsigned int positions_size;
+	}
+}
+
+#endif // __BENCH_HPP__
+// End of file
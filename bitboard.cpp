@@ -30,50 +30,54 @@
 
 namespace checkers
 {
-	unsigned int bitboard::count(void) const
+	namespace
 	{
-		uint32_t x = this->_bitboard;
-
-		x = x - ((x >> 1) & 0x55555555);
-		x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
-		x = (x + (x >> 4)) & 0x0f0f0f0f;
-		x = x + (x >> 8);
-		x = x + (x >> 16);
-		return x & 0x0000003f;
+		/// One step of all the squares of @e x towards @e direction.
+		uint32_t shift(bitboard::direction direction, uint32_t x)
+		{
+			switch (direction)
+			{
+			case bitboard::UP4:
+				return x << 4;
+			case bitboard::UP35:
+				return (x & bitboard::MASK_L3) << 3 |
+					(x & bitboard::MASK_L5) << 5;
+			case bitboard::DOWN4:
+				return x >> 4;
+			case bitboard::DOWN35:
+				return (x & bitboard::MASK_R3) >> 3 |
+					(x & bitboard::MASK_R5) >> 5;
+			default:
+				assert(false);
+				return bitboard::EMPTY;
+			}
+		}
 	}
 
-	unsigned int bitboard::ntz(void) const
+	/**  A diagonal alternates steps of 4 squares and of 3 or 5
+	 *   squares, so a jump lands one step of the other kind past the
+	 *   jumped square.
+	 *  @return Always true.
+	 */
+	bool bitboard::build_tables(void)
 	{
-		uint32_t x = this->_bitboard;
-
-		if (0 == x)
+		static const direction next[DIRECTIONS] =
 		{
-			return 32;
-		}
-
-		unsigned int n = 1;
+			UP35, UP4, DOWN35, DOWN4
+		};
 
-		if (0 == (x & 0x0000ffff))
+		for (unsigned int d = 0; d < DIRECTIONS; ++d)
 		{
-			n += 16;
-			x >>= 16;
+			const direction direction =
+				static_cast<bitboard::direction>(d);
+			for (unsigned int i = 0; i < 32; ++i)
+			{
+				bitboard::_steps[d][i] = shift(direction, 0x1U << i);
+				bitboard::_jumps[d][i] = shift(next[d],
+					bitboard::_steps[d][i]);
+			}
 		}
-		if (0 == (x & 0x000000ff))
-		{
-			n += 8;
-			x >>= 8;
-		}
-		if (0 == (x & 0x0000000f))
-		{
-			n += 4;
-			x >>= 4;
-		}
-		if (0 == (x & 0x00000003))
-		{
-			n += 2;
-			x >>= 2;
-		}
-		return n - (x & 1);
+		return true;
 	}
 
 	std::ostream& operator <<(std::ostream& os, const bitboard& rhs)
@@ -84,6 +88,10 @@ namespace checkers
 
 		return os;
 	}
+
+	uint32_t bitboard::_steps[bitboard::DIRECTIONS][32];
+	uint32_t bitboard::_jumps[bitboard::DIRECTIONS][32];
+	const bool bitboard::_tables = bitboard::build_tables();
 }
 
 // End of file
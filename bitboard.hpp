@@ -31,6 +31,7 @@ extern "C"
 {
 	#include <stdint.h>
 }
+#include <cassert>
 #include <ostream>
 
 namespace checkers
@@ -71,15 +72,31 @@ namespace checkers
 	class bitboard
 	{
 	public:
+		/// Directions of a step along a diagonal.
+		enum direction
+		{
+			/// Up the board, to the square 4 higher.
+			UP4,
+			/// Up the board, to the square 3 or 5 higher.
+			UP35,
+			/// Down the board, to the square 4 lower.
+			DOWN4,
+			/// Down the board, to the square 3 or 5 lower.
+			DOWN35,
+			DIRECTIONS
+		};
+
 		/// Construct from a 32-bit unsigned integer
 		explicit inline bitboard(uint32_t x = bitboard::EMPTY);
 
 		/// Count set bits in bitboard.
-		unsigned int count(void) const;
+		inline unsigned int count(void) const;
 		/// Count the Number of Tail Zeros
-		unsigned int ntz(void) const;
+		inline unsigned int ntz(void) const;
 		/// Get the Least Significant Bit
 		inline bitboard lsb(void) const;
+		/// Get the 32-bit unsigned integer of the bit pattern.
+		inline uint32_t bits(void) const;
 		/// Empty bitboard
 		static const uint32_t EMPTY = 0x0U;
 		/// Black pieces initial position
@@ -128,6 +145,18 @@ namespace checkers
 		 */
 		static const uint32_t WHITE_KINGS_ROW =
 			0x1U <<  0 | 0x1U <<  1 | 0x1U <<  2 | 0x1U <<  3;
+		/** @brief The square next to @e square towards
+		 *   @e direction, empty at the edge of the board.
+		 */
+		inline static bitboard step(direction direction,
+			unsigned int square);
+		/** @brief The landing square of a jump from @e square over
+		 *   the next square towards @e direction, empty at the edge
+		 *   of the board.
+		 */
+		inline static bitboard jump(direction direction,
+			unsigned int square);
+
 		/// Logical left shift by @e rhs bit(s).
 		inline bitboard operator <<(int rhs) const;
 		/// Logical right shift by @e rhs bit(s).
@@ -169,8 +198,16 @@ namespace checkers
 			const bitboard& rhs);
 
 	private:
+		/// Fill the tables of steps and jumps.
+		static bool build_tables(void);
+
 		/// The 32-bit unsigned integer to hold the actual bit pattern
 		uint32_t _bitboard;
+
+		static uint32_t _steps[DIRECTIONS][32];
+		static uint32_t _jumps[DIRECTIONS][32];
+		/// The tables are built during static initialization.
+		static const bool _tables;
 	};
 
 	/// Bitwise OR.
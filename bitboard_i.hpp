@@ -34,11 +34,76 @@ namespace checkers
 	{
 	}
 
+	/**  POPCNT when the target has it (-march=native or -mpopcnt),
+	 *   otherwise the portable SWAR count, which is faster than the
+	 *   library call GCC would make instead of the instruction.
+	 */
+	inline unsigned int bitboard::count(void) const
+	{
+#ifdef __POPCNT__
+		return __builtin_popcount(this->_bitboard);
+#else
+		uint32_t x = this->_bitboard;
+
+		x = x - ((x >> 1) & 0x55555555);
+		x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
+		x = (x + (x >> 4)) & 0x0f0f0f0f;
+		x = x + (x >> 8);
+		x = x + (x >> 16);
+		return x & 0x0000003f;
+#endif
+	}
+
+	/**  TZCNT with BMI1, or BSF and an empty check, otherwise a binary
+	 *   search.
+	 */
+	inline unsigned int bitboard::ntz(void) const
+	{
+		uint32_t x = this->_bitboard;
+
+		if (0 == x)
+		{
+			return 32;
+		}
+#ifdef __GNUC__
+		return __builtin_ctz(x);
+#else
+		unsigned int n = 1;
+
+		if (0 == (x & 0x0000ffff))
+		{
+			n += 16;
+			x >>= 16;
+		}
+		if (0 == (x & 0x000000ff))
+		{
+			n += 8;
+			x >>= 8;
+		}
+		if (0 == (x & 0x0000000f))
+		{
+			n += 4;
+			x >>= 4;
+		}
+		if (0 == (x & 0x00000003))
+		{
+			n += 2;
+			x >>= 2;
+		}
+		return n - (x & 1);
+#endif
+	}
+
 	inline bitboard bitboard::lsb(void) const
 	{
 		return bitboard(this->_bitboard & (-this->_bitboard));
 	}
 
+	inline uint32_t bitboard::bits(void) const
+	{
+		return this->_bitboard;
+	}
+
 	inline bitboard bitboard::operator <<(int rhs) const
 	{
 		return bitboard(this->_bitboard << rhs);
@@ -84,6 +149,20 @@ namespace checkers
 		return *this;
 	}
 
+	inline bitboard bitboard::step(direction direction,
+		unsigned int square)
+	{
+		assert(square < 32);
+		return bitboard(bitboard::_steps[direction][square]);
+	}
+
+	inline bitboard bitboard::jump(direction direction,
+		unsigned int square)
+	{
+		assert(square < 32);
+		return bitboard(bitboard::_jumps[direction][square]);
+	}
+
 	inline bitboard::operator bool(void) const
 	{
 		return this->_bitboard;
@@ -31,6 +31,20 @@
 
 namespace checkers
 {
+	/**  Reset all pieces to initial position and set the player has dark
+	 *   pieces makes the next move.
+	 */ 
+	board::board(void) :
+		_black_pieces(bitboard::BLACK_PIECES_INIT),
+		_white_pieces(bitboard::WHITE_PIECES_INIT),
+		_kings(bitboard::EMPTY), _player(board::BLACK), _zobrist(0x0UL),
+		_cached(0)
+	{
+		this->_zobrist = this->build_zobrist();
+		this->_features[0] = this->build_features<board::BLACK>();
+		this->_features[1] = this->build_features<board::WHITE>();
+	}
+
 	/** @param str The position of checkers board in FEN.
 	 *  A position can be stored by the FEN tag:
 	 *  @verbatim [Turn]:[Color 1][[K][Square number][,]...]:[Color 2][[K][Square number][,]...] @endverbatim
@@ -52,7 +66,7 @@ namespace checkers
 	 */
 	board::board(const std::string& str) :
 		_black_pieces(), _white_pieces(), _kings(), _player(),
-		_zobrist()
+		_zobrist(), _cached(0)
 	{
 		if (str.empty())
 		{
@@ -251,239 +265,36 @@ namespace checkers
 		}
 
 		this->_zobrist = this->build_zobrist();
+		this->_features[0] = this->build_features<board::BLACK>();
+		this->_features[1] = this->build_features<board::WHITE>();
 
 		assert(!(this->_black_pieces & this->_white_pieces));
 		assert(((this->_black_pieces | this->_white_pieces) &
 			this->_kings) == this->_kings);
 	}
 
-	bool board::is_valid_move(const move& move) const
-	{
-		std::vector<class move> legal_moves = this->generate_moves();
-
-		return legal_moves.end() !=
-			std::find(legal_moves.begin(), legal_moves.end(), move);
-	}
-
-	/** @return whether the player has dark pieces move once more.
+	/**  The pieces must not overlap, and the kings must be pieces.
 	 */
-	bool board::make_black_move(const move& move)
-	{
-		this->_black_pieces &= ~move.get_src();
-		this->_zobrist.change_black_piece(move.get_src());
-
-		this->_black_pieces |= move.get_dest();
-		this->_zobrist.change_black_piece(move.get_dest());
-
-		if (this->_kings & move.get_src())
-		{
-			this->_kings &= ~move.get_src();
-			this->_zobrist.change_king(move.get_src());
-
-			this->_kings |= move.get_dest();
-			this->_zobrist.change_king(move.get_dest());
-		}
-
-		if (move.will_crown())
-		{
-			this->_kings |= move.get_dest();
-			this->_zobrist.change_king(move.get_dest());
-		}
-
-		if (move.get_capture())
-		{
-			this->_white_pieces &= ~move.get_capture();
-			this->_zobrist.change_white_piece(move.get_capture());
-
-			if (move.will_capture_a_king())
-			{
-				this->_kings &= ~move.get_capture();
-				this->_zobrist.change_king(move.get_capture());
-			}
-
-			if (!move.will_crown() &&
-				(move.get_dest() & this->get_black_jumpers()))
-			{
-				assert(!(this->_black_pieces &
-					this->_white_pieces));
-				assert(((this->_black_pieces |
-					this->_white_pieces) &
-					this->_kings) == this->_kings);
-				assert(this->build_zobrist() == this->_zobrist);
-				/** @retval true when the player has dark
-				 *   pieces jumps once more (Capture multiple
-				 *   opposing pieces in a single turn).
-				 */
-				return true;
-			}
-		}
-
-		this->_player = board::WHITE;
-		this->_zobrist.change_side();
-
-		assert(!(this->_black_pieces & this->_white_pieces));
-		assert(((this->_black_pieces | this->_white_pieces) &
-			this->_kings) == this->_kings);
-		assert(this->build_zobrist() == this->_zobrist);
-		/// @retval false when change side.
-		return false;
-	}
-
-	/** @return whether the player has light pieces move once more.
-	 */
-	bool board::make_white_move(const move& move)
-	{
-		this->_white_pieces &= ~move.get_src();
-		this->_zobrist.change_white_piece(move.get_src());
-
-		this->_white_pieces |= move.get_dest();
-		this->_zobrist.change_white_piece(move.get_dest());
-
-		if (this->_kings & move.get_src())
-		{
-			this->_kings &= ~move.get_src();
-			this->_zobrist.change_king(move.get_src());
-
-			this->_kings |= move.get_dest();
-			this->_zobrist.change_king(move.get_dest());
-		}
-
-		if (move.will_crown())
-		{
-			this->_kings |= move.get_dest();
-			this->_zobrist.change_king(move.get_dest());
-		}
-
-		if (move.get_capture())
-		{
-			this->_black_pieces &= ~move.get_capture();
-			this->_zobrist.change_black_piece(move.get_capture());
-
-			if (move.will_capture_a_king())
-			{
-				this->_kings &= ~move.get_capture();
-				this->_zobrist.change_king(move.get_capture());
-			}
-
-			if (!move.will_crown() &&
-				(move.get_dest() & this->get_white_jumpers()))
-			{
-				assert(!(this->_black_pieces &
-					this->_white_pieces));
-				assert(((this->_black_pieces |
-					this->_white_pieces) &
-					this->_kings) == this->_kings);
-				assert(this->build_zobrist() == this->_zobrist);
-				/** @retval true when the player has light
-				 *   pieces jumps once more (Capture multiple
-				 *   opposing pieces in a single turn).
-				 */
-				return true;
-			}
-		}
-
-		this->_player = board::BLACK;
-		this->_zobrist.change_side();
-
-		assert(!(this->_black_pieces & this->_white_pieces));
-		assert(((this->_black_pieces | this->_white_pieces) &
-			this->_kings) == this->_kings);
-		assert(this->build_zobrist() == this->_zobrist);
-		/// @retval false when change side.
-		return false;
-	}
-
-	void board::undo_black_move(const move& move)
+	board::board(bitboard black, bitboard white, bitboard kings,
+		player player) :
+		_black_pieces(black), _white_pieces(white), _kings(kings),
+		_player(player), _zobrist(0x0UL), _cached(0)
 	{
-		if (this->is_white_to_move())
-		{
-			this->_player = board::BLACK;
-			this->_zobrist.change_side();
-		}
-
-		if (move.get_capture())
-		{
-			if (move.will_capture_a_king())
-			{
-				this->_kings |= move.get_capture();
-				this->_zobrist.change_king(move.get_capture());
-			}
-
-			this->_white_pieces |= move.get_capture();
-			this->_zobrist.change_white_piece(move.get_capture());
-		}
-
-		if (move.will_crown())
-		{
-			this->_kings &= ~move.get_dest();
-			this->_zobrist.change_king(move.get_dest());
-		}
-
-		if (this->_kings & move.get_dest())
-		{
-			this->_kings &= ~move.get_dest();
-			this->_zobrist.change_king(move.get_dest());
-
-			this->_kings |= move.get_src();
-			this->_zobrist.change_king(move.get_src());
-		}
-
-		this->_black_pieces &= ~move.get_dest();
-		this->_zobrist.change_black_piece(move.get_dest());
-
-		this->_black_pieces |= move.get_src();
-		this->_zobrist.change_black_piece(move.get_src());
+		this->_zobrist = this->build_zobrist();
+		this->_features[0] = this->build_features<board::BLACK>();
+		this->_features[1] = this->build_features<board::WHITE>();
 
 		assert(!(this->_black_pieces & this->_white_pieces));
 		assert(((this->_black_pieces | this->_white_pieces) &
 			this->_kings) == this->_kings);
-		assert(this->build_zobrist() == this->_zobrist);
 	}
 
-	void board::undo_white_move(const move& move)
+	bool board::is_valid_move(const move& move) const
 	{
-		if (this->is_black_to_move())
-		{
-			this->_player = board::WHITE;
-			this->_zobrist.change_side();
-		}
-
-		if (move.get_capture())
-		{
-			if (move.will_capture_a_king())
-			{
-				this->_kings |= move.get_capture();
-				this->_zobrist.change_king(move.get_capture());
-			}
-			this->_black_pieces |= move.get_capture();
-			this->_zobrist.change_black_piece(move.get_capture());
-		}
-
-		if (move.will_crown())
-		{
-			this->_kings &= ~move.get_dest();
-			this->_zobrist.change_king(move.get_dest());
-		}
-
-		if (this->_kings & move.get_dest())
-		{
-			this->_kings &= ~move.get_dest();
-			this->_zobrist.change_king(move.get_dest());
-
-			this->_kings |= move.get_src();
-			this->_zobrist.change_king(move.get_src());
-		}
-
-		this->_white_pieces &= ~move.get_dest();
-		this->_zobrist.change_white_piece(move.get_dest());
-
-		this->_white_pieces |= move.get_src();
-		this->_zobrist.change_white_piece(move.get_src());
+		std::vector<class move> legal_moves = this->generate_moves();
 
-		assert(!(this->_black_pieces & this->_white_pieces));
-		assert(((this->_black_pieces | this->_white_pieces) &
-			this->_kings) == this->_kings);
-		assert(this->build_zobrist() == this->_zobrist);
+		return legal_moves.end() !=
+			std::find(legal_moves.begin(), legal_moves.end(), move);
 	}
 
 	/** @return whether the same player move once more.
@@ -498,185 +309,61 @@ namespace checkers
 		 *  @retval false if the other player will make the next move.
 		 */
 		return this->is_black_to_move() ?
-			this->make_black_move(move) :
-			this->make_white_move(move);
+			this->make_move<board::BLACK>(move) :
+			this->make_move<board::WHITE>(move);
 	}
 
 	void board::undo_move(const move& move)
 	{
 		if (move.get_dest() & this->_black_pieces)
 		{
-			this->undo_black_move(move);
+			this->undo_move<board::BLACK>(move);
 		}
 		else
 		{
-			this->undo_white_move(move);
+			this->undo_move<board::WHITE>(move);
 		}
 
 		assert(this->is_valid_move(move));
 	}
 
-	bitboard board::get_black_movers(void) const
-	{
-		const bitboard unoccupied = this->get_unoccupied();
-		const bitboard black_kings = this->get_black_kings();
-		bitboard movers = (unoccupied >> 4) & this->_black_pieces;
-		movers |= ((unoccupied & bitboard::MASK_R3) >> 3)
-			& this->_black_pieces;
-		movers |= ((unoccupied & bitboard::MASK_R5) >> 5)
-			& this->_black_pieces;
-
-		if (black_kings)
-		{
-			movers |= (unoccupied << 4) & black_kings;
-			movers |= ((unoccupied & bitboard::MASK_L3) << 3)
-				& black_kings;
-			movers |= ((unoccupied & bitboard::MASK_L5) << 5)
-				& black_kings;
-		}
-		return movers;
-	}
-
-	bitboard board::get_white_movers(void) const
-	{
-		const bitboard unoccupied = this->get_unoccupied();
-		const bitboard white_kings = this->get_white_kings();
-		bitboard movers = (unoccupied << 4) & this->_white_pieces;
-		movers |= ((unoccupied & bitboard::MASK_L3) << 3)
-			& this->_white_pieces;
-		movers |= ((unoccupied & bitboard::MASK_L5) << 5)
-			& this->_white_pieces;
-
-		if (white_kings)
-		{
-			movers |= (unoccupied >> 4) & white_kings;
-			movers |= ((unoccupied & bitboard::MASK_R3) >> 3)
-				& white_kings;
-			movers |= ((unoccupied & bitboard::MASK_R5) >> 5)
-				& white_kings;
-		}
-		return movers;
-	}
-
-	bitboard board::get_black_jumpers(void) const
-	{
-		const bitboard unoccupied = this->get_unoccupied();
-		const bitboard black_kings = this->get_black_kings();
-		bitboard movers = bitboard(bitboard::EMPTY);
-		// White pieces next to not occupied squares
-		bitboard temp = (unoccupied >> 4) & this->_white_pieces;
-		if (temp)
-		{
-			movers |= (((temp & bitboard::MASK_R3) >> 3)
-				| ((temp & bitboard::MASK_R5) >> 5))
-				& this->_black_pieces;
-		}
-  		temp = (((unoccupied & bitboard::MASK_R3) >> 3) |
-			((unoccupied & bitboard::MASK_R5) >> 5))
-			& this->_white_pieces;
-		if (temp)
-		{
-			movers |= (temp >> 4) & this->_black_pieces;
-		}
-
-		if (black_kings)
-		{
-			temp = (unoccupied << 4) & this->_white_pieces;
-      			if (temp)
-			{
-				movers |= (((temp & bitboard::MASK_L3) << 3)
-					 | ((temp & bitboard::MASK_L5) << 5))
-					 & black_kings;
-			}
-      			temp = (((unoccupied & bitboard::MASK_L3) << 3) |
-				((unoccupied & bitboard::MASK_L5) << 5))
-				& this->_white_pieces;
-      			if (temp)
-			{
-				movers |= (temp << 4) & black_kings;
-			}
-      		}
-		return movers;
-	}
-
-	bitboard board::get_white_jumpers(void) const
-	{
-		const bitboard unoccupied = this->get_unoccupied();
-		const bitboard white_kings = this->get_white_kings();
-		bitboard movers = bitboard(bitboard::EMPTY);
-		// Black pieces next to not occupied squares
-		bitboard temp = (unoccupied << 4) & this->_black_pieces;
-      		if (temp)
-		{
-			movers |= (((temp & bitboard::MASK_L3) << 3)
-				 | ((temp & bitboard::MASK_L5) << 5))
-				 & this->_white_pieces;
-		}
-      		temp = (((unoccupied & bitboard::MASK_L3) << 3) |
-			((unoccupied & bitboard::MASK_L5) << 5))
-			& this->_black_pieces;
-      		if (temp)
-		{
-			movers |= (temp << 4) & this->_white_pieces;
-		}
-
-		if (white_kings)
-		{
-			temp = (unoccupied >> 4) & this->_black_pieces;
-			if (temp)
-			{
-				movers |= (((temp & bitboard::MASK_R3) >> 3)
-					| ((temp & bitboard::MASK_R5) >> 5))
-					& white_kings;
-			}
-  			temp = (((unoccupied & bitboard::MASK_R3) >> 3) |
-				((unoccupied & bitboard::MASK_R5) >> 5))
-				& this->_black_pieces;
-			if (temp)
-			{
-				movers |= (temp >> 4) & white_kings;
-			}
-		}
-		return movers;
-	}
-
-	std::vector<move> board::generate_black_moves(void) const
+	template <board::player side>
+	std::vector<move> board::generate_simple_moves(void) const
 	{
+		typedef board::traits<side> traits;
 		std::vector<move> moves;
 		moves.reserve(42);
-		bitboard black_movers = this->get_black_movers();
+		bitboard movers = this->get_movers<side>();
 		bitboard src;
 		bitboard dest;
 		const bitboard unoccupied = this->get_unoccupied();
 
-		while (black_movers)
+		while (movers)
 		{
-			src = black_movers.lsb();
-			black_movers &= ~src;
+			src = movers.lsb();
+			movers &= ~src;
 
-			dest = (src << 4) & unoccupied; 
+			dest = traits::forward4(src) & unoccupied;
 			if (dest)
 			{
 				moves.push_back(move(src, dest,
 					bitboard(bitboard::EMPTY), false,
 					!(src & this->_kings) &&
-					(dest & bitboard::BLACK_KINGS_ROW)));
+					(dest & traits::KINGS_ROW)));
 			}
 
-			dest = (((src & bitboard::MASK_L3) << 3) |
-				((src & bitboard::MASK_L5) << 5)) &
-				unoccupied;
+			dest = traits::forward35(src) & unoccupied;
 			if (dest)
 			{
 				moves.push_back(move(src, dest,
 					bitboard(bitboard::EMPTY), false,
 					!(src & this->_kings) &&
-					(dest & bitboard::BLACK_KINGS_ROW)));
+					(dest & traits::KINGS_ROW)));
 			}
 
 			if (src & this->_kings)
 			{
-				dest = (src >> 4) & unoccupied;
+				dest = traits::backward4(src) & unoccupied;
 				if (dest)
 				{
 					moves.push_back(move(src, dest,
@@ -684,9 +371,7 @@ namespace checkers
 						false, false));
 				}
 
-				dest = (((src & bitboard::MASK_R3) >> 3) |
-					((src & bitboard::MASK_R5) >> 5)) &
-					unoccupied;
+				dest = traits::backward35(src) & unoccupied;
 				if (dest)
 				{
 					moves.push_back(move(src, dest,
@@ -699,240 +384,97 @@ namespace checkers
 		return moves;
 	}
 
-	std::vector<move> board::generate_white_moves(void) const
+	template <board::player side>
+	std::vector<move> board::generate_jumps(void) const
 	{
 		std::vector<move> moves;
 		moves.reserve(42);
-		bitboard white_movers = this->get_white_movers();
+		bitboard jumpers = this->get_jumpers<side>();
 		bitboard src;
-		bitboard dest;
-		const bitboard unoccupied = this->get_unoccupied();
 
-		while (white_movers)
+		while (jumpers)
 		{
-			src = white_movers.lsb();
-			white_movers &= ~src;
-
-			dest = (src >> 4) & unoccupied; 
-			if (dest)
-			{
-				moves.push_back(move(src, dest,
-					bitboard(bitboard::EMPTY), false,
-					!(src & this->_kings) &&
-					(dest & bitboard::WHITE_KINGS_ROW)));
-			}
-
-			dest = (((src & bitboard::MASK_R3) >> 3) |
-				((src & bitboard::MASK_R5) >> 5)) &
-				unoccupied;
-			if (dest)
-			{
-				moves.push_back(move(src, dest,
-					bitboard(bitboard::EMPTY), false,
-					!(src & this->_kings) &&
-					(dest & bitboard::WHITE_KINGS_ROW)));
-			}
+			src = jumpers.lsb();
+			jumpers &= ~src;
 
+			this->add_jump<side>(moves, src,
+				board::traits<side>::FORWARD4);
+			this->add_jump<side>(moves, src,
+				board::traits<side>::FORWARD35);
 			if (src & this->_kings)
 			{
-				dest = (src << 4) & unoccupied;
-				if (dest)
-				{
-					moves.push_back(move(src, dest,
-						bitboard(bitboard::EMPTY),
-						false, false));
-				}
-
-				dest = (((src & bitboard::MASK_L3) << 3) |
-					((src & bitboard::MASK_L5) << 5)) &
-					unoccupied;
-				if (dest)
-				{
-					moves.push_back(move(src, dest,
-						bitboard(bitboard::EMPTY),
-						false, false));
-				}
+				this->add_jump<side>(moves, src,
+					board::traits<side>::BACKWARD4);
+				this->add_jump<side>(moves, src,
+					board::traits<side>::BACKWARD35);
 			}
 		}
 
 		return moves;
 	}
 
-	std::vector<move> board::generate_black_jumps(void) const
+	/** @param piece A piece of the player @e side.
+	 */
+	template <board::player side>
+	std::vector<move> board::generate_jumps(bitboard piece) const
 	{
 		std::vector<move> moves;
-		moves.reserve(42);
-		bitboard black_jumpers = this->get_black_jumpers();
-		bitboard src;
-		bitboard dest;
-		bitboard capture;
-		const bitboard unoccupied = this->get_unoccupied();
 
-		while (black_jumpers)
+		this->add_jump<side>(moves, piece,
+			board::traits<side>::FORWARD4);
+		this->add_jump<side>(moves, piece,
+			board::traits<side>::FORWARD35);
+		if (piece & this->_kings)
 		{
-			src = black_jumpers.lsb();
-			black_jumpers &= ~src;
-
-			capture = (src << 4) & this->_white_pieces;
-			if (capture)
-			{
-				dest = (((capture & bitboard::MASK_L3) << 3) |
-					((capture & bitboard::MASK_L5) << 5)) &
-					unoccupied;
-				if (dest)
-				{
-					moves.push_back(move(src, dest,
-						capture, capture & this->_kings,
-						!(src & this->_kings) && (dest
-						& bitboard::BLACK_KINGS_ROW)));
-				}
-			}
-
-			capture = (((src & bitboard::MASK_L3) << 3) |
-				((src & bitboard::MASK_L5) << 5)) &
-				this->_white_pieces;
-			if (capture)
-			{
-				dest = (capture << 4) & unoccupied;
-				if (dest)
-				{
-					moves.push_back(move(src, dest,
-						capture, capture & this->_kings,
-						!(src & this->_kings) && (dest
-						& bitboard::BLACK_KINGS_ROW)));
-				}
-			}
-
-			if (src & this->_kings)
-			{
-				capture = (src >> 4) & this->_white_pieces;
-				if (capture)
-				{
-					dest = (((capture & bitboard::MASK_R3)
-							>> 3) |
-						((capture & bitboard::MASK_R5)
-							>> 5)) & unoccupied;
-					if (dest)
-					{
-						moves.push_back(move(
-							src, dest, capture,
-							capture & this->_kings,
-							false));
-					}
-				}
-
-				capture = (((src & bitboard::MASK_R3) >> 3) |
-					((src & bitboard::MASK_R5) >> 5)) &
-					this->_white_pieces;
-				if (capture)
-				{
-					dest = (capture >> 4) & unoccupied;
-					if (dest)
-					{
-						moves.push_back(move(
-							src, dest, capture,
-							capture & this->_kings,
-							false));
-					}
-				}
-			}
+			this->add_jump<side>(moves, piece,
+				board::traits<side>::BACKWARD4);
+			this->add_jump<side>(moves, piece,
+				board::traits<side>::BACKWARD35);
 		}
 
 		return moves;
 	}
 
-	std::vector<move> board::generate_white_jumps(void) const
+	template <board::player side>
+	std::vector<move> board::generate_legal_moves(void) const
 	{
-		std::vector<move> moves;
-		moves.reserve(42);
-		bitboard white_jumpers = this->get_white_jumpers();
-		bitboard src;
-		bitboard dest;
-		bitboard capture;
-		const bitboard unoccupied = this->get_unoccupied();
-
-		while (white_jumpers)
-		{
-			src = white_jumpers.lsb();
-			white_jumpers &= ~src;
-
-			capture = (src >> 4) & this->_black_pieces;
-			if (capture)
-			{
-				dest = (((capture & bitboard::MASK_R3) >> 3) |
-					((capture & bitboard::MASK_R5) >> 5)) &
-					unoccupied;
-				if (dest)
-				{
-					moves.push_back(move(src, dest,
-						capture, capture & this->_kings,
-						!(src & this->_kings) && (dest
-						& bitboard::WHITE_KINGS_ROW)));
-				}
-			}
-
-			capture = (((src & bitboard::MASK_R3) >> 3) |
-				((src & bitboard::MASK_R5) >> 5)) &
-				this->_black_pieces;
-			if (capture)
-			{
-				dest = (capture >> 4) & unoccupied;
-				if (dest)
-				{
-					moves.push_back(move(src, dest,
-						capture, capture & this->_kings,
-						!(src & this->_kings) && (dest
-						& bitboard::WHITE_KINGS_ROW)));
-				}
-			}
-
-			if (src & this->_kings)
-			{
-				capture = (src << 4) & this->_black_pieces;
-				if (capture)
-				{
-					dest = (((capture & bitboard::MASK_L3)
-							<< 3) |
-						((capture & bitboard::MASK_L5)
-							<< 5)) & unoccupied;
-					if (dest)
-					{
-						moves.push_back(move( 
-							src, dest, capture,
-							capture & this->_kings,
-							false));
-					}
-				}
+		return this->get_jumpers<side>() ?
+			this->generate_jumps<side>() :
+			this->generate_simple_moves<side>();
+	}
 
-				capture = (((src & bitboard::MASK_L3) << 3) |
-					((src & bitboard::MASK_L5) << 5)) &
-					this->_black_pieces;
-				if (capture)
-				{
-					dest = (capture << 4) & unoccupied;
-					if (dest)
-					{
-						moves.push_back(move(
-							src, dest, capture,
-							capture & this->_kings,
-							false));
-					}
-				}
-			}
-		}
+	template std::vector<move>
+		board::generate_simple_moves<board::BLACK>(void) const;
+	template std::vector<move>
+		board::generate_simple_moves<board::WHITE>(void) const;
+	template std::vector<move>
+		board::generate_jumps<board::BLACK>(void) const;
+	template std::vector<move>
+		board::generate_jumps<board::WHITE>(void) const;
+	template std::vector<move>
+		board::generate_jumps<board::BLACK>(bitboard) const;
+	template std::vector<move>
+		board::generate_jumps<board::WHITE>(bitboard) const;
+	template std::vector<move>
+		board::generate_legal_moves<board::BLACK>(void) const;
+	template std::vector<move>
+		board::generate_legal_moves<board::WHITE>(void) const;
 
-		return moves;
+	std::vector<move> board::generate_moves(void) const
+	{
+		return this->is_black_to_move() ?
+			this->generate_legal_moves<board::BLACK>() :
+			this->generate_legal_moves<board::WHITE>();
 	}
 
-	std::vector<move> board::generate_moves(void) const
+	/** @param piece The piece of the player on move, which has just
+	 *   jumped.
+	 */
+	std::vector<move> board::generate_jumps(bitboard piece) const
 	{
-		return (this->is_black_to_move()) ?
-			(this->get_black_jumpers() ?
-				this->generate_black_jumps() :
-				this->generate_black_moves()) :
-			(this->get_white_jumpers() ?
-				this->generate_white_jumps() :
-				this->generate_white_moves());
+		return this->is_black_to_move() ?
+			this->generate_jumps<board::BLACK>(piece) :
+			this->generate_jumps<board::WHITE>(piece);
 	}
 
 	/** @param str The movetext.
@@ -37,23 +37,56 @@ namespace checkers
 	class board
 	{
 	public:
+		/// The player on move.
+		enum player
+		{
+			/// Player has dark pieces.
+			BLACK = 1,
+			/// Player has light pieces.
+			WHITE = -BLACK
+		};
+
+		/// Terms of the evaluation counted for each player.
+		enum feature
+		{
+			/// Men.
+			MEN,
+			/// Kings.
+			KINGS,
+			/** Pieces on the own kings row, which keep the enemy men
+			 *  from crowning.
+			 */
+			HOME_ROW,
+			/// Pieces on the edges of the board.
+			EDGE,
+			FEATURES
+		};
+
+		/** @brief Directions and pieces of the player @e side, the
+		 *   move generator is instantiated for each player with them.
+		 */
+		template <player side>
+		struct traits;
+
 		/// Default constructor.
-		inline board(void);
+		board(void);
 		/// Construct from an user input string.
 		explicit board(const std::string& input);
+		/// Construct from the pieces and the player to move.
+		board(bitboard black, bitboard white, bitboard kings,
+			player player);
+		/// Copy the position, but not the cached movers and jumpers.
+		inline board(const board& rhs);
 
 		/// Check if move is legal based on current situation
 		bool is_valid_move(const move& move) const;
 
-		/// Make a move by the player has dark pieces.
-		bool make_black_move(const move& move);
-		/// Make a move by the player has light pieces.
-		bool make_white_move(const move& move);
-
-		/// Undo a move made by the player has dark pieces.
-		void undo_black_move(const move& move);
-		/// Undo a move made by the player has light pieces.
-		void undo_white_move(const move& move);
+		/// Make a move by the player @e side.
+		template <player side>
+		inline bool make_move(const move& move);
+		/// Undo a move made by the player @e side.
+		template <player side>
+		inline void undo_move(const move& move);
 
 		/// Make one move.
 		bool make_move(const move& move);
@@ -92,31 +125,64 @@ namespace checkers
 
 		/// Get Zobrist key.
 		inline zobrist get_zobrist(void) const;
+		/** @brief Get the count of @e feature of the player @e side,
+		 *   kept up to date by make_move and undo_move.
+		 */
+		inline unsigned int get_feature(player side,
+			feature feature) const;
+
+		/** @brief Get all pieces of the player @e side, which can
+		 *   move, computed once per position.
+		 */
+		template <player side>
+		inline bitboard get_movers(void) const;
+		/** @brief Get all pieces of the player @e side, which can
+		 *   jump and capture an enemy piece, computed once per
+		 *   position.
+		 */
+		template <player side>
+		inline bitboard get_jumpers(void) const;
+
+		/** @brief Check whether one piece of the player @e side can
+		 *   jump and capture an enemy piece.
+		 */
+		template <player side>
+		inline bool can_jump(bitboard piece) const;
 
 		/// Get all dark pieces, which can move.
-		bitboard get_black_movers(void) const;
+		inline bitboard get_black_movers(void) const;
 		/// Get all light pieces, which can move.
-		bitboard get_white_movers(void) const;
+		inline bitboard get_white_movers(void) const;
 		/** @brief Get all dark pieces, which can jump and capture an
 		 *   enemy piece.
 		 */
-		bitboard get_black_jumpers(void) const;
+		inline bitboard get_black_jumpers(void) const;
 		/** @brief Get all light pieces, which can jump and capture an
 		 *   enemy piece.
 		 */
-		bitboard get_white_jumpers(void) const;
-
-		/// Generate all legal moves for dark pieces.
-		std::vector<move> generate_black_moves(void) const;
-		/// Generate all legal moves for light pieces.
-		std::vector<move> generate_white_moves(void) const;
-		/// Generate all legal jumps for dark pieces.
-		std::vector<move> generate_black_jumps(void) const;
-		/// Generate all legal jumps for light pieces.
-		std::vector<move> generate_white_jumps(void) const;
+		inline bitboard get_white_jumpers(void) const;
+
+		/// Generate all legal simple moves for the player @e side.
+		template <player side>
+		std::vector<move> generate_simple_moves(void) const;
+		/// Generate all legal jumps for the player @e side.
+		template <player side>
+		std::vector<move> generate_jumps(void) const;
+		/// Generate all legal jumps of one piece of the player @e side.
+		template <player side>
+		std::vector<move> generate_jumps(bitboard piece) const;
+		/** @brief Generate all legal moves for the player @e side,
+		 *   the jumps if there are any.
+		 */
+		template <player side>
+		std::vector<move> generate_legal_moves(void) const;
 
 		/// Generate all legal moves based on game board.
 		std::vector<move> generate_moves(void) const;
+		/** @brief Generate all legal jumps of the piece, which jumps
+		 *   once more in the current turn.
+		 */
+		std::vector<move> generate_jumps(bitboard piece) const;
 		/// Parse user move @e.
 		move parse_move(const std::string& str) const;
 
@@ -130,16 +196,28 @@ namespace checkers
 		bool is_losing(void) const;
 		
 	private:
-		enum player
-		{
-			/// Player has dark pieces.
-			BLACK = 1,
-			/// Player has light pieces.
-			WHITE = -BLACK
-		};
+		/// Compute all pieces of the player @e side, which can move.
+		template <player side>
+		inline bitboard compute_movers(void) const;
+		/** @brief Compute all pieces of the player @e side, which can
+		 *   jump and capture an enemy piece.
+		 */
+		template <player side>
+		inline bitboard compute_jumpers(void) const;
+
+		/// Add the jump of @e piece towards @e direction if legal.
+		template <player side>
+		inline void add_jump(std::vector<move>& moves, bitboard piece,
+			bitboard::direction direction) const;
 
 		/// Build Zobrist key.
 		zobrist build_zobrist(void);
+		/// The features of a piece of the player @e side on @e piece.
+		template <player side>
+		inline static uint32_t features(bitboard piece, bool is_king);
+		/// Count the features of the player @e side from scratch.
+		template <player side>
+		inline uint32_t build_features(void) const;
 
 		/// All the dark pieces on the game board.
 		bitboard _black_pieces;
@@ -153,6 +231,18 @@ namespace checkers
 		player _player;
 		/// The Zobrist key
 		zobrist _zobrist;
+		/// Feature counts of each player, 8 bits a feature.
+		uint32_t _features[2];
+
+		/// Movers of each player, valid while flagged in @e _cached.
+		mutable bitboard _movers[2];
+		/// Jumpers of each player, valid while flagged in @e _cached.
+		mutable bitboard _jumpers[2];
+		/** @brief Bit 0 and 1 flag valid movers, bit 2 and 3 valid
+		 *   jumpers, of the player with the index.  Cleared by any
+		 *   change of the pieces.
+		 */
+		mutable unsigned int _cached;
 	};
 
 	/// Stream out the current game board.
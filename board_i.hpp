@@ -29,15 +29,162 @@
 
 namespace checkers
 {
-	/**  Reset all pieces to initial position and set the player has dark
-	 *   pieces makes the next move.
-	 */ 
-	inline board::board(void) :
-		_black_pieces(bitboard::BLACK_PIECES_INIT),
-		_white_pieces(bitboard::WHITE_PIECES_INIT),
-		_kings(bitboard::EMPTY), _player(board::BLACK), _zobrist(0x0UL)
+	/**  Black moves up the board, towards the higher squares.
+	 */
+	template <>
+	struct board::traits<board::BLACK>
+	{
+		/// Index of the player in the caches of the board.
+		static const unsigned int INDEX = 0;
+		/// Directions forward, for men and kings.
+		static const bitboard::direction FORWARD4 = bitboard::UP4;
+		static const bitboard::direction FORWARD35 = bitboard::UP35;
+		/// Directions backward, for kings only.
+		static const bitboard::direction BACKWARD4 = bitboard::DOWN4;
+		static const bitboard::direction BACKWARD35 = bitboard::DOWN35;
+		/// The other player.
+		static const player opponent = board::WHITE;
+		/// Men will become king when reach this row.
+		static const uint32_t KINGS_ROW = bitboard::BLACK_KINGS_ROW;
+		/// The own kings row, where the enemy men crown.
+		static const uint32_t HOME_ROW = bitboard::WHITE_KINGS_ROW;
+
+		/// One step forward, along the file of 4 squares apart.
+		static inline bitboard forward4(const bitboard& squares)
+		{
+			return squares << 4;
+		}
+		/// One step forward, along the other diagonal.
+		static inline bitboard forward35(const bitboard& squares)
+		{
+			return ((squares & bitboard::MASK_L3) << 3) |
+				((squares & bitboard::MASK_L5) << 5);
+		}
+		/// One step backward, along the file of 4 squares apart.
+		static inline bitboard backward4(const bitboard& squares)
+		{
+			return squares >> 4;
+		}
+		/// One step backward, along the other diagonal.
+		static inline bitboard backward35(const bitboard& squares)
+		{
+			return ((squares & bitboard::MASK_R3) >> 3) |
+				((squares & bitboard::MASK_R5) >> 5);
+		}
+
+		static inline bitboard& pieces(board& board)
+		{
+			return board._black_pieces;
+		}
+		static inline bitboard& enemies(board& board)
+		{
+			return board._white_pieces;
+		}
+		static inline const bitboard& pieces(const board& board)
+		{
+			return board._black_pieces;
+		}
+		static inline const bitboard& enemies(const board& board)
+		{
+			return board._white_pieces;
+		}
+
+		static inline void change_piece(zobrist& zobrist,
+			const bitboard& piece)
+		{
+			zobrist.change_black_piece(piece);
+		}
+		static inline void change_enemy(zobrist& zobrist,
+			const bitboard& piece)
+		{
+			zobrist.change_white_piece(piece);
+		}
+	};
+
+	/**  White moves down the board, towards the lower squares.
+	 */
+	template <>
+	struct board::traits<board::WHITE>
 	{
-		this->_zobrist = this->build_zobrist();
+		/// Index of the player in the caches of the board.
+		static const unsigned int INDEX = 1;
+		/// Directions forward, for men and kings.
+		static const bitboard::direction FORWARD4 = bitboard::DOWN4;
+		static const bitboard::direction FORWARD35 = bitboard::DOWN35;
+		/// Directions backward, for kings only.
+		static const bitboard::direction BACKWARD4 = bitboard::UP4;
+		static const bitboard::direction BACKWARD35 = bitboard::UP35;
+		/// The other player.
+		static const player opponent = board::BLACK;
+		/// Men will become king when reach this row.
+		static const uint32_t KINGS_ROW = bitboard::WHITE_KINGS_ROW;
+		/// The own kings row, where the enemy men crown.
+		static const uint32_t HOME_ROW = bitboard::BLACK_KINGS_ROW;
+
+		/// One step forward, along the file of 4 squares apart.
+		static inline bitboard forward4(const bitboard& squares)
+		{
+			return squares >> 4;
+		}
+		/// One step forward, along the other diagonal.
+		static inline bitboard forward35(const bitboard& squares)
+		{
+			return ((squares & bitboard::MASK_R3) >> 3) |
+				((squares & bitboard::MASK_R5) >> 5);
+		}
+		/// One step backward, along the file of 4 squares apart.
+		static inline bitboard backward4(const bitboard& squares)
+		{
+			return squares << 4;
+		}
+		/// One step backward, along the other diagonal.
+		static inline bitboard backward35(const bitboard& squares)
+		{
+			return ((squares & bitboard::MASK_L3) << 3) |
+				((squares & bitboard::MASK_L5) << 5);
+		}
+
+		static inline bitboard& pieces(board& board)
+		{
+			return board._white_pieces;
+		}
+		static inline bitboard& enemies(board& board)
+		{
+			return board._black_pieces;
+		}
+		static inline const bitboard& pieces(const board& board)
+		{
+			return board._white_pieces;
+		}
+		static inline const bitboard& enemies(const board& board)
+		{
+			return board._black_pieces;
+		}
+
+		static inline void change_piece(zobrist& zobrist,
+			const bitboard& piece)
+		{
+			zobrist.change_white_piece(piece);
+		}
+		static inline void change_enemy(zobrist& zobrist,
+			const bitboard& piece)
+		{
+			zobrist.change_black_piece(piece);
+		}
+	};
+
+	// ================================================================
+
+	/**  A copy is made to make a move on it, which would drop the
+	 *   cache at once.
+	 */
+	inline board::board(const board& rhs) :
+		_black_pieces(rhs._black_pieces),
+		_white_pieces(rhs._white_pieces), _kings(rhs._kings),
+		_player(rhs._player), _zobrist(rhs._zobrist), _cached(0)
+	{
+		this->_features[0] = rhs._features[0];
+		this->_features[1] = rhs._features[1];
 	}
 
 	inline bitboard board::get_black_pieces(void) const
@@ -105,6 +252,368 @@ namespace checkers
 	{
 		return this->_zobrist;
 	} 
+
+	inline unsigned int board::get_feature(player side,
+		feature feature) const
+	{
+		return (this->_features[board::BLACK == side ? 0 : 1] >>
+			(8 * feature)) & 0xffU;
+	}
+
+	/** @return whether the player @e side moves once more.
+	 */
+	template <board::player side>
+	inline bool board::make_move(const move& move)
+	{
+		typedef board::traits<side> traits;
+		typedef board::traits<board::traits<side>::opponent> enemy;
+		bitboard& pieces = traits::pieces(*this);
+		const bool is_king = this->_kings & move.get_src();
+
+		assert(side == this->_player);
+
+		this->_cached = 0;
+		this->_features[traits::INDEX] +=
+			board::features<side>(move.get_dest(),
+				is_king || move.will_crown()) -
+			board::features<side>(move.get_src(), is_king);
+		if (move.get_capture())
+		{
+			this->_features[enemy::INDEX] -=
+				board::features<traits::opponent>(
+					move.get_capture(),
+					move.will_capture_a_king());
+		}
+
+		pieces &= ~move.get_src();
+		traits::change_piece(this->_zobrist, move.get_src());
+
+		pieces |= move.get_dest();
+		traits::change_piece(this->_zobrist, move.get_dest());
+
+		if (this->_kings & move.get_src())
+		{
+			this->_kings &= ~move.get_src();
+			this->_zobrist.change_king(move.get_src());
+
+			this->_kings |= move.get_dest();
+			this->_zobrist.change_king(move.get_dest());
+		}
+
+		if (move.will_crown())
+		{
+			this->_kings |= move.get_dest();
+			this->_zobrist.change_king(move.get_dest());
+		}
+
+		if (move.get_capture())
+		{
+			traits::enemies(*this) &= ~move.get_capture();
+			traits::change_enemy(this->_zobrist, move.get_capture());
+
+			if (move.will_capture_a_king())
+			{
+				this->_kings &= ~move.get_capture();
+				this->_zobrist.change_king(move.get_capture());
+			}
+
+			if (!move.will_crown() &&
+				this->can_jump<side>(move.get_dest()))
+			{
+				assert(!(this->_black_pieces &
+					this->_white_pieces));
+				assert(((this->_black_pieces |
+					this->_white_pieces) &
+					this->_kings) == this->_kings);
+				assert(this->build_zobrist() == this->_zobrist);
+				assert(this->build_features<side>() ==
+					this->_features[traits::INDEX]);
+				assert(this->build_features<
+					traits::opponent>() ==
+					this->_features[enemy::INDEX]);
+				/** @retval true when the player jumps once more
+				 *   (Capture multiple opposing pieces in a
+				 *   single turn).
+				 */
+				return true;
+			}
+		}
+
+		this->_player = traits::opponent;
+		this->_zobrist.change_side();
+
+		assert(!(this->_black_pieces & this->_white_pieces));
+		assert(((this->_black_pieces | this->_white_pieces) &
+			this->_kings) == this->_kings);
+		assert(this->build_zobrist() == this->_zobrist);
+		assert(this->build_features<side>() ==
+			this->_features[traits::INDEX]);
+		assert(this->build_features<traits::opponent>() ==
+			this->_features[enemy::INDEX]);
+		/// @retval false when change side.
+		return false;
+	}
+
+	template <board::player side>
+	inline void board::undo_move(const move& move)
+	{
+		typedef board::traits<side> traits;
+		typedef board::traits<board::traits<side>::opponent> enemy;
+		bitboard& pieces = traits::pieces(*this);
+		const bool is_king = !move.will_crown() &&
+			(this->_kings & move.get_dest());
+
+		if (side != this->_player)
+		{
+			this->_player = side;
+			this->_zobrist.change_side();
+		}
+		this->_cached = 0;
+		this->_features[traits::INDEX] +=
+			board::features<side>(move.get_src(), is_king) -
+			board::features<side>(move.get_dest(),
+				is_king || move.will_crown());
+		if (move.get_capture())
+		{
+			this->_features[enemy::INDEX] +=
+				board::features<traits::opponent>(
+					move.get_capture(),
+					move.will_capture_a_king());
+		}
+
+		if (move.get_capture())
+		{
+			if (move.will_capture_a_king())
+			{
+				this->_kings |= move.get_capture();
+				this->_zobrist.change_king(move.get_capture());
+			}
+
+			traits::enemies(*this) |= move.get_capture();
+			traits::change_enemy(this->_zobrist, move.get_capture());
+		}
+
+		if (move.will_crown())
+		{
+			this->_kings &= ~move.get_dest();
+			this->_zobrist.change_king(move.get_dest());
+		}
+
+		if (this->_kings & move.get_dest())
+		{
+			this->_kings &= ~move.get_dest();
+			this->_zobrist.change_king(move.get_dest());
+
+			this->_kings |= move.get_src();
+			this->_zobrist.change_king(move.get_src());
+		}
+
+		pieces &= ~move.get_dest();
+		traits::change_piece(this->_zobrist, move.get_dest());
+
+		pieces |= move.get_src();
+		traits::change_piece(this->_zobrist, move.get_src());
+
+		assert(!(this->_black_pieces & this->_white_pieces));
+		assert(((this->_black_pieces | this->_white_pieces) &
+			this->_kings) == this->_kings);
+		assert(this->build_zobrist() == this->_zobrist);
+		assert(this->build_features<side>() ==
+			this->_features[traits::INDEX]);
+		assert(this->build_features<traits::opponent>() ==
+			this->_features[enemy::INDEX]);
+	}
+
+	/** @return The features packed 8 bits a feature, to be added to or
+	 *   subtracted from the counts of the player @e side.
+	 */
+	template <board::player side>
+	inline uint32_t board::features(bitboard piece, bool is_king)
+	{
+		uint32_t features = 0x1U << (8 * (is_king ? board::KINGS :
+			board::MEN));
+
+		if (piece & board::traits<side>::HOME_ROW)
+		{
+			features += 0x1U << (8 * board::HOME_ROW);
+		}
+		if (piece & bitboard::EDGES)
+		{
+			features += 0x1U << (8 * board::EDGE);
+		}
+		return features;
+	}
+
+	template <board::player side>
+	inline uint32_t board::build_features(void) const
+	{
+		typedef board::traits<side> traits;
+		const bitboard& pieces = traits::pieces(*this);
+
+		return (pieces & ~this->_kings).count() << (8 * board::MEN) |
+			(pieces & this->_kings).count() << (8 * board::KINGS) |
+			(pieces & traits::HOME_ROW).count() <<
+				(8 * board::HOME_ROW) |
+			(pieces & bitboard::EDGES).count() << (8 * board::EDGE);
+	}
+
+	template <board::player side>
+	inline bitboard board::get_movers(void) const
+	{
+		const unsigned int i = board::traits<side>::INDEX;
+
+		if (!(this->_cached & (0x1U << i)))
+		{
+			this->_movers[i] = this->compute_movers<side>();
+			this->_cached |= 0x1U << i;
+		}
+		return this->_movers[i];
+	}
+
+	template <board::player side>
+	inline bitboard board::get_jumpers(void) const
+	{
+		const unsigned int i = board::traits<side>::INDEX;
+
+		if (!(this->_cached & (0x4U << i)))
+		{
+			this->_jumpers[i] = this->compute_jumpers<side>();
+			this->_cached |= 0x4U << i;
+		}
+		return this->_jumpers[i];
+	}
+
+	template <board::player side>
+	inline bitboard board::compute_movers(void) const
+	{
+		typedef board::traits<side> traits;
+		const bitboard unoccupied = this->get_unoccupied();
+		const bitboard& pieces = traits::pieces(*this);
+		const bitboard kings = pieces & this->_kings;
+		bitboard movers = (traits::backward4(unoccupied) |
+			traits::backward35(unoccupied)) & pieces;
+
+		if (kings)
+		{
+			movers |= (traits::forward4(unoccupied) |
+				traits::forward35(unoccupied)) & kings;
+		}
+		return movers;
+	}
+
+	template <board::player side>
+	inline bitboard board::compute_jumpers(void) const
+	{
+		typedef board::traits<side> traits;
+		const bitboard unoccupied = this->get_unoccupied();
+		const bitboard& pieces = traits::pieces(*this);
+		const bitboard& enemies = traits::enemies(*this);
+		const bitboard kings = pieces & this->_kings;
+		bitboard movers = bitboard(bitboard::EMPTY);
+		// Enemy pieces next to not occupied squares
+		bitboard temp = traits::backward4(unoccupied) & enemies;
+		if (temp)
+		{
+			movers |= traits::backward35(temp) & pieces;
+		}
+		temp = traits::backward35(unoccupied) & enemies;
+		if (temp)
+		{
+			movers |= traits::backward4(temp) & pieces;
+		}
+
+		if (kings)
+		{
+			temp = traits::forward4(unoccupied) & enemies;
+			if (temp)
+			{
+				movers |= traits::forward35(temp) & kings;
+			}
+			temp = traits::forward35(unoccupied) & enemies;
+			if (temp)
+			{
+				movers |= traits::forward4(temp) & kings;
+			}
+		}
+		return movers;
+	}
+
+	/** @param piece A piece of the player @e side.
+	 *  @return Whether @e piece can jump and capture an enemy piece.
+	 */
+	template <board::player side>
+	inline bool board::can_jump(bitboard piece) const
+	{
+		typedef board::traits<side> traits;
+		const unsigned int square = piece.ntz();
+		const bitboard unoccupied = this->get_unoccupied();
+		const bitboard& enemies = traits::enemies(*this);
+
+		if (((bitboard::step(traits::FORWARD4, square) & enemies) &&
+			(bitboard::jump(traits::FORWARD4, square) &
+				unoccupied)) ||
+			((bitboard::step(traits::FORWARD35, square) & enemies) &&
+			(bitboard::jump(traits::FORWARD35, square) &
+				unoccupied)))
+		{
+			return true;
+		}
+		return (piece & this->_kings) &&
+			(((bitboard::step(traits::BACKWARD4, square) &
+				enemies) &&
+			(bitboard::jump(traits::BACKWARD4, square) &
+				unoccupied)) ||
+			((bitboard::step(traits::BACKWARD35, square) &
+				enemies) &&
+			(bitboard::jump(traits::BACKWARD35, square) &
+				unoccupied)));
+	}
+
+	/**  Add the jump of @e piece towards @e direction to @e moves, if
+	 *   there is an enemy piece to capture and room to land.
+	 */
+	template <board::player side>
+	inline void board::add_jump(std::vector<move>& moves, bitboard piece,
+		bitboard::direction direction) const
+	{
+		typedef board::traits<side> traits;
+		const unsigned int square = piece.ntz();
+		const bitboard capture = bitboard::step(direction, square) &
+			traits::enemies(*this);
+
+		if (capture)
+		{
+			const bitboard dest = bitboard::jump(direction, square) &
+				this->get_unoccupied();
+			if (dest)
+			{
+				moves.push_back(move(piece, dest, capture,
+					capture & this->_kings,
+					!(piece & this->_kings) &&
+					(dest & traits::KINGS_ROW)));
+			}
+		}
+	}
+
+	inline bitboard board::get_black_movers(void) const
+	{
+		return this->get_movers<board::BLACK>();
+	}
+
+	inline bitboard board::get_white_movers(void) const
+	{
+		return this->get_movers<board::WHITE>();
+	}
+
+	inline bitboard board::get_black_jumpers(void) const
+	{
+		return this->get_jumpers<board::BLACK>();
+	}
+
+	inline bitboard board::get_white_jumpers(void) const
+	{
+		return this->get_jumpers<board::WHITE>();
+	}
 }
 
 #endif // __BOARD_I_HPP__
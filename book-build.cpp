@@ -0,0 +1,139 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file book-build.cpp
+ *  @brief Build an opening book from games.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include "builder.hpp"
+
+void usage(void)
+{
+	std::cerr
+		<< "Usage: book-build [--plies N] [--min-games N] [--depth D]"
+		<< " [--workers N]\n"
+		<< "                  --output FILE PDN...\n"
+		<< "\n"
+		<< "Add up the moves of the first N plies, 20 by default, of"
+		<< " the games of\n"
+		<< "the PDN files, and write the positions of at least N"
+		<< " games, 3 by default,\n"
+		<< "to the opening book FILE.  With a depth D, verify the"
+		<< " moves by searches to\n"
+		<< "depth D in N processes, and extend the lines by the moves"
+		<< " found.\n"
+		<< std::flush;
+}
+
+int main(int argc, char* argv[])
+{
+	try
+	{
+		std::vector<std::string> files;
+		std::string output;
+		unsigned int plies = 20;
+		unsigned int min_games = 3;
+		unsigned int depth = 0;
+		unsigned int workers = 1;
+		int i = 0;
+
+		while (++i < argc)
+		{
+			const std::string arg(argv[i]);
+
+			if (("--plies" == arg || "--min-games" == arg ||
+				"--depth" == arg || "--workers" == arg ||
+				"--output" == arg) && i + 1 >= argc)
+			{
+				usage();
+				std::exit(255);
+			}
+			if ("--plies" == arg)
+			{
+				plies = std::strtoul(argv[++i], NULL, 10);
+			}
+			else if ("--min-games" == arg)
+			{
+				min_games = std::strtoul(argv[++i], NULL, 10);
+			}
+			else if ("--depth" == arg)
+			{
+				depth = std::strtoul(argv[++i], NULL, 10);
+			}
+			else if ("--workers" == arg)
+			{
+				workers = std::strtoul(argv[++i], NULL, 10);
+			}
+			else if ("--output" == arg)
+			{
+				output = argv[++i];
+			}
+			else if ('-' == arg[0])
+			{
+				usage();
+				std::exit(255);
+			}
+			else
+			{
+				files.push_back(arg);
+			}
+		}
+		if (files.empty() || output.empty() || 0 == workers)
+		{
+			usage();
+			std::exit(255);
+		}
+
+		checkers::builder builder(plies, std::max(1U, min_games));
+		for (std::vector<std::string>::const_iterator pos =
+			files.begin(); pos != files.end(); ++pos)
+		{
+			builder.add(*pos);
+		}
+		std::cout << "games " << builder.games() << ", skipped "
+			<< builder.skipped() << ", positions " << builder.size()
+			<< '\n';
+
+		builder.weigh();
+		std::cout << "positions of " << std::max(1U, min_games)
+			<< " games or more " << builder.size() << '\n'
+			<< std::flush;
+		if (depth)
+		{
+			builder.verify(depth, workers, std::cout);
+		}
+		builder.save(output);
+	}
+	catch (std::exception& e)
+	{
+		std::cerr << "Fatal error: " << e.what() << std::endl;
+		std::exit(255);
+	}
+
+	return 0;
+}
+
+// End of file
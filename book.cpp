@@ -0,0 +1,262 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file book.cpp
+ *  @brief Opening book.
+ */
+
+extern "C"
+{
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+}
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include "book.hpp"
+
+namespace checkers
+{
+	namespace
+	{
+		const char MAGIC[4] = { 'B', 'O', 'O', 'K' };
+		/// Bytes of the header, the magic, version and size.
+		const size_t HEADER = 16;
+
+		/// Order of the entries by the key only.
+		inline bool key_less(const book::entry& lhs, uint64_t key)
+		{
+			return lhs.key < key;
+		}
+	}
+
+	/**  The book of a previous file is closed first, also when the new
+	 *   file is bad.
+	 */
+	void book::open(const std::string& filename)
+	{
+		book::close();
+
+		const int fd = ::open(filename.c_str(), O_RDONLY);
+		struct stat status;
+
+		if (fd < 0 || fstat(fd, &status) < 0)
+		{
+			if (fd >= 0)
+			{
+				::close(fd);
+			}
+			/// @throw std::runtime_error when the file cannot be
+			///  opened.
+			throw std::runtime_error(
+				"Error (cannot open opening book): " + filename);
+		}
+		book::_length = status.st_size;
+		book::_map = book::_length ? mmap(NULL, book::_length,
+			PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+		::close(fd);
+		if (MAP_FAILED == book::_map)
+		{
+			book::_map = NULL;
+			/// @throw std::runtime_error when the file cannot be
+			///  mapped.
+			throw std::runtime_error(
+				"Error (cannot map opening book): " + filename);
+		}
+
+		const uint8_t* const map = static_cast<uint8_t*>(book::_map);
+		uint32_t version = 0;
+		uint64_t size = 0;
+
+		if (book::_length >= HEADER)
+		{
+			std::memcpy(&version, map + sizeof(MAGIC),
+				sizeof(version));
+			std::memcpy(&size, map + sizeof(MAGIC) + sizeof(version),
+				sizeof(size));
+		}
+		book::_entries = reinterpret_cast<const entry*>(map + HEADER);
+		book::_size = size_t(size);
+
+		bool good = book::_length >= HEADER &&
+			0 == std::memcmp(map, MAGIC, sizeof(MAGIC)) &&
+			book::version == version &&
+			(book::_length - HEADER) / sizeof(entry) == size &&
+			(book::_length - HEADER) % sizeof(entry) == 0;
+		// The binary search needs the entries in order.
+		for (size_t i = 1; good && i < book::_size; ++i)
+		{
+			good = book::_entries[i - 1] < book::_entries[i];
+		}
+		if (!good)
+		{
+			book::close();
+			/// @throw std::runtime_error when the file is not a
+			///  book, or is cut short.
+			throw std::runtime_error(
+				"Error (bad opening book): " + filename);
+		}
+	}
+
+	void book::close(void)
+	{
+		if (book::_map)
+		{
+			munmap(book::_map, book::_length);
+		}
+		book::_map = NULL;
+		book::_length = 0;
+		book::_entries = NULL;
+		book::_size = 0;
+	}
+
+	size_t book::find(uint64_t key, const entry*& first)
+	{
+		const entry* const end = book::_entries + book::_size;
+		const entry* last;
+
+		first = std::lower_bound(book::_entries, end, key, key_less);
+		for (last = first; last != end && key == last->key; ++last)
+		{
+		}
+		return last - first;
+	}
+
+	/**  The moves of the book are checked against the legal moves, so
+	 *   a collision of the keys is not played.
+	 */
+	bool book::choose(const board& board, std::vector<move>& turn,
+		entry& chosen)
+	{
+		checkers::board next(board);
+		bitboard jumper(bitboard::EMPTY);
+		bool more = true;
+
+		turn.clear();
+		while (more)
+		{
+			const entry* first;
+			const entry* best = NULL;
+			const size_t count = book::find(next.get_zobrist().key(),
+				first);
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				if (first[i].weight &&
+					(!best || first[i].weight > best->weight))
+				{
+					best = &first[i];
+				}
+			}
+
+			const std::vector<move> moves = jumper ?
+				next.generate_jumps(jumper) : next.generate_moves();
+			std::vector<move>::const_iterator pos = moves.begin();
+			while (best && pos != moves.end() &&
+				!(pos->get_src().ntz() == best->src &&
+				pos->get_dest().ntz() == best->dest))
+			{
+				++pos;
+			}
+			if (!best || pos == moves.end())
+			{
+				turn.clear();
+				return false;
+			}
+
+			if (turn.empty())
+			{
+				chosen = *best;
+			}
+			turn.push_back(*pos);
+			jumper = pos->get_dest();
+			more = next.make_move(*pos);
+		}
+		return true;
+	}
+
+	/**  The file begins with the magic "BOOK", the 32-bit version and
+	 *   the 64-bit number of entries, then the entries in order.  A
+	 *   move of a position is kept once, the entries of the same move
+	 *   are added up.
+	 */
+	void book::save(const std::string& filename,
+		std::vector<entry>& entries)
+	{
+		std::sort(entries.begin(), entries.end());
+
+		std::vector<entry>::iterator last = entries.begin();
+		for (std::vector<entry>::const_iterator pos = entries.begin();
+			pos != entries.end(); ++pos)
+		{
+			if (last != entries.begin() && !(*(last - 1) < *pos))
+			{
+				entry& entry = *(last - 1);
+				const unsigned int weight = entry.weight + pos->weight;
+
+				entry.weight = uint16_t(weight > 0xffffU ? 0xffffU :
+					weight);
+				entry.wins += pos->wins;
+				entry.draws += pos->draws;
+				entry.losses += pos->losses;
+			}
+			else
+			{
+				*last++ = *pos;
+			}
+		}
+		entries.erase(last, entries.end());
+
+		std::ofstream file(filename.c_str(),
+			std::ios::out | std::ios::binary | std::ios::trunc);
+		const uint64_t size = entries.size();
+
+		file.write(MAGIC, sizeof(MAGIC));
+		file.write(reinterpret_cast<const char*>(&book::version),
+			sizeof(book::version));
+		file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+		if (!entries.empty())
+		{
+			file.write(reinterpret_cast<const char*>(&entries[0]),
+				entries.size() * sizeof(entry));
+		}
+		file.close();
+		if (!file)
+		{
+			/// @throw std::runtime_error when the file cannot be
+			///  written.
+			throw std::runtime_error(
+				"Error (cannot write opening book): " + filename);
+		}
+	}
+
+	const uint32_t book::version;
+	void* book::_map = NULL;
+	size_t book::_length = 0;
+	const book::entry* book::_entries = NULL;
+	size_t book::_size = 0;
+}
+
+// End of file
@@ -0,0 +1,110 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file book.hpp
+ *  @brief Opening book.
+ */
+
+#ifndef __BOOK_HPP__
+#define __BOOK_HPP__
+
+extern "C"
+{
+	#include <stddef.h>
+	#include <stdint.h>
+}
+#include <string>
+#include <vector>
+#include "board.hpp"
+
+namespace checkers
+{
+	/** @class book
+	 *  @brief Opening book, the moves played from the positions of
+	 *   the opening with their weights and results.
+	 *
+	 *   The book is an array of entries sorted by the zobrist key of
+	 *   the position, one for each move.  The file is mapped into
+	 *   memory, and the moves of a position are found by a binary
+	 *   search.  A multiple jump is kept jump by jump, each from the
+	 *   position before it.
+	 */
+	class book
+	{
+	public:
+		/// A move from a position.
+		struct entry
+		{
+			/// Zobrist key of the position.
+			uint64_t key;
+			/// Source square of the move, from 0.
+			uint8_t src;
+			/// Destination square of the move, from 0.
+			uint8_t dest;
+			/// Weight of the move, never played when 0.
+			uint16_t weight;
+			/// Games won, drawn and lost by the player to move.
+			uint32_t wins;
+			uint32_t draws;
+			uint32_t losses;
+
+			inline bool operator <(const entry& rhs) const;
+		};
+
+		/// Version of the book file.
+		static const uint32_t version = 1;
+
+		/// Map the book of @e filename into memory.
+		static void open(const std::string& filename);
+		/// Unmap the book.
+		static void close(void);
+		/// Whether a book is open.
+		inline static bool is_open(void);
+		/** @brief Find the entries of the position of @e key.
+		 *  @return The number of entries from @e first.
+		 */
+		static size_t find(uint64_t key, const entry*& first);
+		/** @brief Choose the turn of the player to move with the
+		 *   highest weight in the book.
+		 *  @param chosen The entry of the first move of the turn.
+		 *  @return Whether @e board and the rest of the turn are in
+		 *   the book.
+		 */
+		static bool choose(const board& board, std::vector<move>& turn,
+			entry& chosen);
+
+		/// Sort @e entries and write them to @e filename.
+		static void save(const std::string& filename,
+			std::vector<entry>& entries);
+
+	private:
+		/// The file mapped into memory, or NULL.
+		static void* _map;
+		static size_t _length;
+		static const entry* _entries;
+		static size_t _size;
+	};
+}
+
+#include "book_i.hpp"
+#endif // __BOOK_HPP__
+// End of file
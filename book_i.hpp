@@ -0,0 +1,50 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file book_i.hpp
+ *  @brief Opening book.
+ */
+
+#ifndef __BOOK_I_HPP__
+#define __BOOK_I_HPP__
+
+namespace checkers
+{
+	/**  By the key, then by the move.
+	 */
+	inline bool book::entry::operator <(const entry& rhs) const
+	{
+		return this->key != rhs.key ? this->key < rhs.key :
+			this->src != rhs.src ? this->src < rhs.src :
+			this->dest < rhs.dest;
+	}
+
+	// ================================================================
+
+	inline bool book::is_open(void)
+	{
+		return NULL != book::_map;
+	}
+}
+
+#endif // __BOOK_I_HPP__
+// End of file
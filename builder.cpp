@@ -0,0 +1,569 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file builder.cpp
+ *  @brief Build an opening book from games.
+ */
+
+extern "C"
+{
+	#include <sys/select.h>
+	#include <sys/types.h>
+	#include <sys/wait.h>
+	#include <unistd.h>
+}
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include "absearch.hpp"
+#include "builder.hpp"
+
+namespace checkers
+{
+	namespace
+	{
+		/// Time limit, long enough to always reach the depth.
+		const time_t NO_TIME_LIMIT = 999999;
+		/// Square of no move.
+		const uint8_t NONE = 0xff;
+
+		/** @return Whether a whole result has been read, false at the
+		 *   end of file.
+		 */
+		bool read_all(int fd, void* data, size_t size)
+		{
+			char* buffer = static_cast<char*>(data);
+			size_t done = 0;
+
+			while (done < size)
+			{
+				const ssize_t count = read(fd, buffer + done,
+					size - done);
+				if (count < 0 && EINTR == errno)
+				{
+					continue;
+				}
+				if (count < 0)
+				{
+					/// @throw std::runtime_error when read()
+					///  failed.
+					throw std::runtime_error(
+						std::string("read() failed: ") +
+						std::strerror(errno));
+				}
+				if (0 == count)
+				{
+					return false;
+				}
+				done += count;
+			}
+			return true;
+		}
+	}
+
+	builder::builder(unsigned int plies, unsigned int min_games) :
+		_plies(plies), _min_games(min_games), _games(0), _skipped(0),
+		_positions()
+	{
+	}
+
+	void builder::add(const std::string& filename)
+	{
+		std::ifstream file(filename.c_str());
+
+		if (!file)
+		{
+			/// @throw std::runtime_error when the file cannot be
+			///  opened.
+			throw std::runtime_error("Error (cannot open games): " +
+				filename);
+		}
+
+		pdn reader(file);
+		pdn::game game;
+		while (reader.next(game))
+		{
+			this->add(game);
+		}
+	}
+
+	void builder::weigh(void)
+	{
+		positions::iterator pos = this->_positions.begin();
+
+		while (pos != this->_positions.end())
+		{
+			if (pos->second.games < this->_min_games)
+			{
+				this->_positions.erase(pos++);
+				continue;
+			}
+			for (std::vector<book::entry>::iterator entry =
+				pos->second.moves.begin();
+				entry != pos->second.moves.end(); ++entry)
+			{
+				const unsigned long int points =
+					2 * entry->wins + entry->draws;
+
+				entry->weight = entry->wins + entry->draws +
+					entry->losses < this->_min_games ? 0 :
+					uint16_t(points > 0xffffU ? 0xffffU : points);
+			}
+			++pos;
+		}
+	}
+
+	/**  Only the positions at the start of a turn are searched, and
+	 *   the moves which end the turn, as a search cannot begin in the
+	 *   middle of a jump.  A move is searched to a ply less than its
+	 *   position, to the same horizon.
+	 */
+	void builder::verify(unsigned int depth, unsigned int workers,
+		std::ostream& log)
+	{
+		std::vector<job> jobs;
+		std::vector<position> leaves;
+
+		for (positions::const_iterator pos = this->_positions.begin();
+			pos != this->_positions.end(); ++pos)
+		{
+			if (!pos->second.start)
+			{
+				continue;
+			}
+
+			const job job = { pos->first, -1 };
+			jobs.push_back(job);
+			for (size_t i = 0; i < pos->second.moves.size(); ++i)
+			{
+				board board = builder::get_board(pos->second);
+				const int n = builder::find(board,
+					pos->second.moves[i]);
+
+				if (!pos->second.moves[i].weight || n < 0 ||
+					board.make_move(board.generate_moves()[n]))
+				{
+					continue;
+				}
+
+				const builder::job next = { pos->first, int(i) };
+				const position leaf =
+				{
+					board.get_black_pieces().bits(),
+					board.get_white_pieces().bits(),
+					board.get_kings().bits(),
+					board.is_black_to_move(), true, 0,
+					std::vector<book::entry>()
+				};
+				jobs.push_back(next);
+				if (this->_positions.find(board.get_zobrist().key()) ==
+					this->_positions.end())
+				{
+					leaves.push_back(leaf);
+				}
+			}
+		}
+		for (std::vector<position>::const_iterator pos = leaves.begin();
+			pos != leaves.end(); ++pos)
+		{
+			const uint64_t key =
+				builder::get_board(*pos).get_zobrist().key();
+
+			if (this->_positions.insert(std::make_pair(key, *pos)).second)
+			{
+				const job job = { key, -1 };
+				jobs.push_back(job);
+			}
+		}
+
+		log << "searching " << jobs.size() << " positions to depth "
+			<< depth << '\n' << std::flush;
+
+		std::vector<result> results(jobs.size());
+		this->search(jobs, results, depth, workers);
+
+		// The best values first, then the moves against them.
+		std::tr1::unordered_map<uint64_t, size_t> best;
+		unsigned long int refuted = 0;
+		unsigned long int extended = 0;
+		size_t i;
+
+		for (i = 0; i < jobs.size(); ++i)
+		{
+			if (jobs[i].move < 0)
+			{
+				best[jobs[i].key] = i;
+			}
+		}
+		for (i = 0; i < jobs.size(); ++i)
+		{
+			if (jobs[i].move < 0)
+			{
+				continue;
+			}
+
+			book::entry& entry =
+				this->_positions[jobs[i].key].moves[jobs[i].move];
+			if (-results[i].value <
+				results[best[jobs[i].key]].value - builder::margin)
+			{
+				entry.weight = 0;
+				++refuted;
+			}
+		}
+
+		// The positions without a move to play take the best move.
+		for (i = 0; i < jobs.size(); ++i)
+		{
+			position& position = this->_positions[jobs[i].key];
+			const result& result = results[i];
+			bool weighted = false;
+
+			if (jobs[i].move >= 0 || NONE == result.src)
+			{
+				continue;
+			}
+			for (std::vector<book::entry>::const_iterator pos =
+				position.moves.begin(); pos != position.moves.end();
+				++pos)
+			{
+				weighted = weighted || pos->weight;
+			}
+			if (weighted)
+			{
+				continue;
+			}
+
+			std::vector<book::entry>::iterator pos =
+				position.moves.begin();
+			while (pos != position.moves.end() &&
+				!(result.src == pos->src && result.dest == pos->dest))
+			{
+				++pos;
+			}
+			if (pos == position.moves.end())
+			{
+				const book::entry entry =
+				{
+					jobs[i].key, result.src, result.dest, 0, 0, 0, 0
+				};
+				pos = position.moves.insert(pos, entry);
+			}
+			pos->weight = 1;
+			++extended;
+		}
+
+		log << "refuted " << refuted << " moves, extended " << extended
+			<< " positions\n" << std::flush;
+	}
+
+	void builder::save(const std::string& filename) const
+	{
+		std::vector<book::entry> entries;
+
+		for (positions::const_iterator pos = this->_positions.begin();
+			pos != this->_positions.end(); ++pos)
+		{
+			entries.insert(entries.end(), pos->second.moves.begin(),
+				pos->second.moves.end());
+		}
+		book::save(filename, entries);
+	}
+
+	/**  A game without a result, or with a bad position or turn, is
+	 *   skipped.
+	 */
+	void builder::add(const pdn::game& game)
+	{
+		board board;
+
+		if (!game.fen.empty())
+		{
+			try
+			{
+				board = checkers::board(game.fen);
+			}
+			catch (const std::logic_error&)
+			{
+				++this->_skipped;
+				return;
+			}
+		}
+
+		checkers::board next(board);
+		std::vector<std::vector<move> > turns;
+		for (size_t i = 0; i < game.turns.size() && i < this->_plies;
+			++i)
+		{
+			turns.push_back(std::vector<move>());
+			if (!pdn::parse_turn(next, game.turns[i], turns.back()))
+			{
+				++this->_skipped;
+				return;
+			}
+			for (std::vector<move>::const_iterator pos =
+				turns.back().begin(); pos != turns.back().end(); ++pos)
+			{
+				next.make_move(*pos);
+			}
+		}
+		if (game.result < 0)
+		{
+			++this->_skipped;
+			return;
+		}
+
+		for (std::vector<std::vector<move> >::const_iterator turn =
+			turns.begin(); turn != turns.end(); ++turn)
+		{
+			for (std::vector<move>::const_iterator pos = turn->begin();
+				pos != turn->end(); ++pos)
+			{
+				this->add(board, pos == turn->begin(), *pos,
+					game.result);
+				board.make_move(*pos);
+			}
+		}
+		++this->_games;
+	}
+
+	void builder::add(const board& board, bool start, const move& move,
+		int result)
+	{
+		const uint64_t key = board.get_zobrist().key();
+		position& position = this->_positions[key];
+		const int points = board.is_black_to_move() ? result :
+			2 - result;
+
+		if (0 == position.games)
+		{
+			position.black = board.get_black_pieces().bits();
+			position.white = board.get_white_pieces().bits();
+			position.kings = board.get_kings().bits();
+			position.black_to_move = board.is_black_to_move();
+			position.start = start;
+		}
+		++position.games;
+
+		std::vector<book::entry>::iterator pos = position.moves.begin();
+		while (pos != position.moves.end() &&
+			!(move.get_src().ntz() == pos->src &&
+			move.get_dest().ntz() == pos->dest))
+		{
+			++pos;
+		}
+		if (pos == position.moves.end())
+		{
+			const book::entry entry =
+			{
+				key, uint8_t(move.get_src().ntz()),
+				uint8_t(move.get_dest().ntz()), 0, 0, 0, 0
+			};
+			pos = position.moves.insert(pos, entry);
+		}
+		pos->wins += 2 == points;
+		pos->draws += 1 == points;
+		pos->losses += 0 == points;
+	}
+
+	board builder::get_board(const position& position)
+	{
+		return board(bitboard(position.black), bitboard(position.white),
+			bitboard(position.kings), position.black_to_move ?
+			board::BLACK : board::WHITE);
+	}
+
+	int builder::find(const board& board, const book::entry& entry)
+	{
+		const std::vector<move> moves = board.generate_moves();
+
+		for (size_t i = 0; i < moves.size(); ++i)
+		{
+			if (moves[i].get_src().ntz() == entry.src &&
+				moves[i].get_dest().ntz() == entry.dest)
+			{
+				return int(i);
+			}
+		}
+		return -1;
+	}
+
+	void builder::worker(int fd, const std::vector<job>& jobs,
+		unsigned int first, unsigned int workers,
+		unsigned int depth) const
+	{
+		try
+		{
+			for (size_t i = first; i < jobs.size(); i += workers)
+			{
+				const position& position =
+					this->_positions.find(jobs[i].key)->second;
+				board board = builder::get_board(position);
+				std::vector<move> best_moves;
+				result result = { uint32_t(i), NONE, NONE, 0 };
+
+				if (jobs[i].move >= 0)
+				{
+					board.make_move(board.generate_moves()[
+						builder::find(board,
+						position.moves[jobs[i].move])]);
+				}
+				absearch::clear_hash();
+				absearch::think(best_moves, board, jobs[i].move < 0 ||
+					depth < 2 ? depth : depth - 1, NO_TIME_LIMIT,
+					false, false);
+				if (!best_moves.empty())
+				{
+					result.src = best_moves.front().get_src().ntz();
+					result.dest = best_moves.front().get_dest().ntz();
+				}
+				result.value = absearch::get_value();
+				if (write(fd, &result, sizeof(result)) !=
+					sizeof(result))
+				{
+					_exit(1);
+				}
+			}
+		}
+		catch (...)
+		{
+			_exit(1);
+		}
+		_exit(0);
+	}
+
+	/**  The jobs are searched from an empty hash table, so the results
+	 *   do not depend on the number of workers.
+	 */
+	void builder::search(const std::vector<job>& jobs,
+		std::vector<result>& results, unsigned int depth,
+		unsigned int workers) const
+	{
+		std::vector<int> fds;
+		std::vector<pid_t> pids;
+		unsigned int i;
+
+		for (i = 0; i < workers; ++i)
+		{
+			int fd[2];
+			pid_t pid;
+
+			if (pipe(fd) < 0)
+			{
+				/// @throw std::runtime_error when pipe() failed.
+				throw std::runtime_error(std::string(
+					"pipe() failed: ") + std::strerror(errno));
+			}
+			if ((pid = fork()) < 0)
+			{
+				/// @throw std::runtime_error when fork() failed.
+				throw std::runtime_error(std::string(
+					"fork() failed: ") + std::strerror(errno));
+			}
+			else if (0 == pid)
+			{
+				// Child
+				close(fd[0]);
+				for (size_t j = 0; j < fds.size(); ++j)
+				{
+					close(fds[j]);
+				}
+				this->worker(fd[1], jobs, i, workers, depth);
+			}
+			close(fd[1]);
+			fds.push_back(fd[0]);
+			pids.push_back(pid);
+		}
+
+		// Read from every worker as its results come, so that no
+		// worker waits on a full pipe.  A result is written at once,
+		// so a readable pipe holds a whole result or the end of file.
+		size_t count = 0;
+		size_t open = fds.size();
+		while (open)
+		{
+			fd_set read_set;
+			int max_fd = -1;
+
+			FD_ZERO(&read_set);
+			for (i = 0; i < workers; ++i)
+			{
+				if (fds[i] >= 0)
+				{
+					FD_SET(fds[i], &read_set);
+					max_fd = std::max(max_fd, fds[i]);
+				}
+			}
+			if (select(max_fd + 1, &read_set, NULL, NULL, NULL) < 0)
+			{
+				if (EINTR == errno)
+				{
+					continue;
+				}
+				/// @throw std::runtime_error when select() failed.
+				throw std::runtime_error(std::string(
+					"select() failed: ") + std::strerror(errno));
+			}
+			for (i = 0; i < workers; ++i)
+			{
+				result result;
+
+				if (fds[i] < 0 || !FD_ISSET(fds[i], &read_set))
+				{
+					continue;
+				}
+				if (read_all(fds[i], &result, sizeof(result)))
+				{
+					results[result.job] = result;
+					++count;
+				}
+				else
+				{
+					close(fds[i]);
+					fds[i] = -1;
+					--open;
+				}
+			}
+		}
+
+		bool failed = false;
+		for (i = 0; i < workers; ++i)
+		{
+			int status;
+
+			while (waitpid(pids[i], &status, 0) < 0 && EINTR == errno)
+			{
+			}
+			failed = failed || !WIFEXITED(status) ||
+				WEXITSTATUS(status) != 0;
+		}
+		if (failed || count != jobs.size())
+		{
+			/// @throw std::runtime_error when a worker failed.
+			throw std::runtime_error("Error (book search failed)");
+		}
+	}
+}
+
+// End of file
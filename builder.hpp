@@ -0,0 +1,167 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file builder.hpp
+ *  @brief Build an opening book from games.
+ */
+
+#ifndef __BUILDER_HPP__
+#define __BUILDER_HPP__
+
+extern "C"
+{
+	#include <stddef.h>
+	#include <stdint.h>
+}
+#include <ostream>
+#include <string>
+#include <tr1/unordered_map>
+#include <vector>
+#include "board.hpp"
+#include "book.hpp"
+#include "pdn.hpp"
+
+namespace checkers
+{
+	/** @class builder
+	 *  @brief Build an opening book from the games of PDN files.
+	 *
+	 *   The turns of the games up to a number of plies are added up
+	 *   by position, in a hash map by the zobrist key, with the games
+	 *   won, drawn and lost after each move by the player to move.
+	 *   The positions of fewer games are dropped, and each move of
+	 *   enough games is weighted by its points, 2 for a win and 1 for
+	 *   a draw.
+	 *
+	 *   The book may then be verified by searches to a fixed depth,
+	 *   shared out to worker processes, each with its own hash table.
+	 *   A move whose value is below the best of its position by more
+	 *   than a margin is weighted 0.  The positions left without a
+	 *   move to play, and the positions the moves of the book lead
+	 *   to, are given the move found by the search, so the lines of
+	 *   the book go one turn further.
+	 */
+	class builder
+	{
+	public:
+		/** @brief Add the first @e plies turns of the games, and keep
+		 *   the positions of at least @e min_games games.
+		 */
+		builder(unsigned int plies, unsigned int min_games);
+
+		/// Add the games of the PDN file @e filename.
+		void add(const std::string& filename);
+		/// Get the number of positions.
+		inline size_t size(void) const;
+		/// Get the number of games added.
+		inline unsigned long int games(void) const;
+		/// Get the number of games skipped as unreadable.
+		inline unsigned long int skipped(void) const;
+
+		/// Weight the moves and drop the positions of few games.
+		void weigh(void);
+		/** @brief Verify the moves by searches to @e depth in
+		 *   @e workers processes, and show the counts on @e log.
+		 */
+		void verify(unsigned int depth, unsigned int workers,
+			std::ostream& log);
+		/// Write the book to @e filename.
+		void save(const std::string& filename) const;
+
+		/** @brief How much worse than the best move of its position
+		 *   a move may be.
+		 */
+		static const int margin = 100;
+
+	private:
+		/// A position of the games.
+		struct position
+		{
+			uint32_t black;
+			uint32_t white;
+			uint32_t kings;
+			bool black_to_move;
+			/// Whether at the start of a turn, not in a jump.
+			bool start;
+			/// Number of the games through the position.
+			unsigned long int games;
+			std::vector<book::entry> moves;
+		};
+
+		/** @brief A search of a position, or of the position after
+		 *   one of its moves.
+		 */
+		struct job
+		{
+			uint64_t key;
+			/// Index of the move, or -1.
+			int move;
+		};
+
+		/// The result of a job.
+		struct result
+		{
+			uint32_t job;
+			/// The best move, or 0xff when there is none.
+			uint8_t src;
+			uint8_t dest;
+			/// The value for the player to move.
+			int32_t value;
+		};
+
+		typedef std::tr1::unordered_map<uint64_t, position> positions;
+
+		/// Add the turns of @e game.
+		void add(const pdn::game& game);
+		/** @brief Add the move @e move of @e board to the games of
+		 *   @e result, in half points for Black.
+		 */
+		void add(const board& board, bool start, const move& move,
+			int result);
+		/// Get the board of @e position.
+		static board get_board(const position& position);
+		/** @brief Get the index in the moves of @e board of the move
+		 *   of @e entry.
+		 *  @return The index, or -1 when it is not legal.
+		 */
+		static int find(const board& board, const book::entry& entry);
+
+		/// Search every @e workers th job from @e first.
+		void worker(int fd, const std::vector<job>& jobs,
+			unsigned int first, unsigned int workers,
+			unsigned int depth) const;
+		/// Run the @e jobs in @e workers processes.
+		void search(const std::vector<job>& jobs,
+			std::vector<result>& results, unsigned int depth,
+			unsigned int workers) const;
+
+		unsigned int _plies;
+		unsigned int _min_games;
+		unsigned long int _games;
+		unsigned long int _skipped;
+		positions _positions;
+	};
+}
+
+#include "builder_i.hpp"
+#endif // __BUILDER_HPP__
+// End of file
@@ -0,0 +1,128 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file dataset-pack.cpp
+ *  @brief Write datasets of positions as packed datasets.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include "dataset.hpp"
+#include "packed.hpp"
+
+void usage(void)
+{
+	std::cerr
+		<< "Usage: dataset-pack --output FILE DATASET...\n"
+		<< "\n"
+		<< "Write the positions of the DATASETs, lines of FEN and"
+		<< " results, games in\n"
+		<< "PDN or packed datasets, to the packed dataset FILE, 16"
+		<< " bytes a position,\n"
+		<< "for tune and ``bench read FILE''.  The lines and games"
+		<< " which cannot be\n"
+		<< "read are shown and skipped.\n"
+		<< std::flush;
+}
+
+int main(int argc, char* argv[])
+{
+	try
+	{
+		std::vector<std::string> files;
+		std::string output;
+		int i = 0;
+
+		while (++i < argc)
+		{
+			const std::string arg(argv[i]);
+
+			if ("--output" == arg && i + 1 >= argc)
+			{
+				usage();
+				std::exit(255);
+			}
+			if ("--output" == arg)
+			{
+				output = argv[++i];
+			}
+			else if ('-' == arg[0])
+			{
+				usage();
+				std::exit(255);
+			}
+			else
+			{
+				files.push_back(arg);
+			}
+		}
+		if (files.empty() || output.empty())
+		{
+			usage();
+			std::exit(255);
+		}
+
+		checkers::packed::writer writer(output);
+		size_t errors = 0;
+		for (std::vector<std::string>::const_iterator pos =
+			files.begin(); pos != files.end(); ++pos)
+		{
+			checkers::dataset dataset(*pos);
+			checkers::dataset::sample sample;
+
+			while (dataset.next(sample))
+			{
+				const checkers::packed::record record =
+				{
+					sample.black, sample.white, sample.kings,
+					checkers::packed::to_score(sample.score),
+					uint8_t(sample.black_to_move ? 1 : 0),
+					int8_t(sample.result)
+				};
+
+				writer.write(record);
+			}
+			for (std::vector<checkers::dataset::error>::const_iterator
+				error = dataset.get_errors().begin();
+				error != dataset.get_errors().end(); ++error)
+			{
+				std::cerr << *pos << ':' << error->line << ": "
+					<< error->message << '\n';
+			}
+			errors += dataset.get_errors().size();
+		}
+		writer.close();
+		std::cout << "positions " << writer.size() << ", errors "
+			<< errors << '\n';
+	}
+	catch (std::exception& e)
+	{
+		std::cerr << "Fatal error: " << e.what() << std::endl;
+		std::exit(255);
+	}
+
+	return 0;
+}
+
+// End of file
@@ -0,0 +1,423 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file dataset.cpp
+ *  @brief Streaming reader of datasets of positions.
+ */
+
+extern "C"
+{
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+}
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include "dataset.hpp"
+
+namespace checkers
+{
+	namespace
+	{
+		inline bool is_blank(char c)
+		{
+			return ' ' == c || '\t' == c || '\r' == c || '\n' == c;
+		}
+
+		/// Move @e p over the blanks up to @e end.
+		inline void skip_blanks(const char*& p, const char* end)
+		{
+			while (p != end && is_blank(*p))
+			{
+				++p;
+			}
+		}
+	}
+
+	dataset::dataset(const std::string& filename) :
+		_map(NULL), _length(0), _begin(NULL), _end(NULL), _next(NULL),
+		_line(1), _counted(0), _pdn(false), _buffer(NULL),
+		_stream(NULL), _reader(NULL), _game(NULL), _turn(0), _start(0),
+		_playing(false), _board(), _packed(NULL), _index(0),
+		_errors()
+	{
+		const int fd = ::open(filename.c_str(), O_RDONLY);
+		struct stat status;
+
+		if (fd < 0 || fstat(fd, &status) < 0)
+		{
+			if (fd >= 0)
+			{
+				::close(fd);
+			}
+			/// @throw std::runtime_error when the file cannot be
+			///  opened.
+			throw std::runtime_error("Error (cannot open dataset): "
+				+ filename);
+		}
+		this->_length = status.st_size;
+		if (this->_length)
+		{
+			this->_map = mmap(NULL, this->_length, PROT_READ,
+				MAP_PRIVATE, fd, 0);
+		}
+		::close(fd);
+		if (MAP_FAILED == this->_map)
+		{
+			/// @throw std::runtime_error when the file cannot be
+			///  mapped.
+			throw std::runtime_error("Error (cannot map dataset): "
+				+ filename);
+		}
+		if (this->_map && packed::is_packed(
+			static_cast<const char*>(this->_map), this->_length))
+		{
+			munmap(this->_map, this->_length);
+			this->_map = NULL;
+			this->_length = 0;
+			this->_packed = new packed(filename);
+		}
+		if (this->_map)
+		{
+			// The file is read once from the beginning to the end.
+			madvise(this->_map, this->_length, MADV_SEQUENTIAL);
+		}
+
+		this->_begin = static_cast<const char*>(this->_map);
+		this->_end = this->_begin + this->_length;
+		this->_next = this->_begin;
+
+		const char* p = this->_begin;
+		skip_blanks(p, this->_end);
+		this->_pdn = p != this->_end && '[' == *p;
+		if (this->_pdn)
+		{
+			this->_buffer = new buffer(this->_begin, this->_end);
+			this->_stream = new std::istream(this->_buffer);
+			this->_reader = new pdn(*this->_stream);
+			this->_game = new pdn::game();
+		}
+	}
+
+	dataset::~dataset(void)
+	{
+		delete this->_packed;
+		delete this->_game;
+		delete this->_reader;
+		delete this->_stream;
+		delete this->_buffer;
+		if (this->_map)
+		{
+			munmap(this->_map, this->_length);
+		}
+	}
+
+	bool dataset::next(sample& sample)
+	{
+		return this->_packed ? this->next_record(sample) :
+			this->_pdn ? this->next_game(sample) :
+			this->next_line(sample);
+	}
+
+	/**  The grammar is that of board::board(const std::string&), the
+	 *   player to move, then the pieces of each color after a ':' and
+	 *   the color, the squares joined by ',', a king marked by 'K'.
+	 *   A '.' may end the FEN, as in PDN.
+	 */
+	bool dataset::parse_fen(const char*& p, const char* end,
+		sample& sample, const char*& message)
+	{
+		uint32_t pieces[2] = { 0, 0 };
+		uint32_t kings = 0;
+		unsigned int color = 0;
+
+		if (p == end || ('B' != *p && 'W' != *p))
+		{
+			message = "illegal FEN, no player to move";
+			return false;
+		}
+		sample.black_to_move = 'B' == *p++;
+		if (p == end || ':' != *p)
+		{
+			message = "illegal FEN, no pieces";
+			return false;
+		}
+
+		while (p != end && ':' == *p)
+		{
+			++p;
+			if (p != end && ('B' == *p || 'W' == *p))
+			{
+				color = 'W' == *p++ ? 1 : 0;
+			}
+			for (;;)
+			{
+				const bool king = p != end && 'K' == *p;
+				unsigned int square = 0;
+
+				if (king)
+				{
+					++p;
+				}
+				const char* const digits = p;
+				while (p != end && *p >= '0' && *p <= '9' &&
+					square <= 32)
+				{
+					square = square * 10 + (*p++ - '0');
+				}
+				if (p == digits || 0 == square || square > 32)
+				{
+					message = "illegal FEN, square number out of"
+						" range";
+					return false;
+				}
+
+				const uint32_t piece = 0x1U << (square - 1);
+				if ((pieces[0] | pieces[1]) & piece)
+				{
+					message = "illegal FEN, square number repeated";
+					return false;
+				}
+				pieces[color] |= piece;
+				if (king)
+				{
+					kings |= piece;
+				}
+				if (p == end || ',' != *p)
+				{
+					break;
+				}
+				++p;
+			}
+		}
+		if (p != end && '.' == *p)
+		{
+			++p;
+		}
+		if (p != end && !is_blank(*p))
+		{
+			message = "illegal FEN, unexpected character";
+			return false;
+		}
+
+		sample.black = pieces[0];
+		sample.white = pieces[1];
+		sample.kings = kings;
+		return true;
+	}
+
+	int dataset::parse_result(const char*& p, const char* end)
+	{
+		const char* first = p;
+
+		while (p != end && !is_blank(*p))
+		{
+			++p;
+		}
+
+		const char* last = p;
+		while (first != last && ('[' == *first || '"' == *first))
+		{
+			++first;
+		}
+		while (first != last &&
+			(']' == last[-1] || '"' == last[-1] || ';' == last[-1]))
+		{
+			--last;
+		}
+
+		// Short enough to be copied onto the stack for strtod.
+		char text[16];
+		const size_t size = size_t(last - first);
+		if (0 == size || size >= sizeof(text))
+		{
+			return -1;
+		}
+		std::memcpy(text, first, size);
+		text[size] = '\0';
+
+		if (0 == std::strcmp(text, "1-0"))
+		{
+			return 2;
+		}
+		if (0 == std::strcmp(text, "0-1"))
+		{
+			return 0;
+		}
+		if (0 == std::strcmp(text, "1/2-1/2"))
+		{
+			return 1;
+		}
+
+		char* tail;
+		const double value = std::strtod(text, &tail);
+		if ('\0' != *tail ||
+			(0.0 != value && 0.5 != value && 1.0 != value))
+		{
+			return -1;
+		}
+		return int(value * 2.0);
+	}
+
+	/**  The stream never writes, the buffer is only read.
+	 */
+	dataset::buffer::buffer(const char* begin, const char* end)
+	{
+		this->setg(const_cast<char*>(begin), const_cast<char*>(begin),
+			const_cast<char*>(end));
+	}
+
+	bool dataset::next_line(sample& sample)
+	{
+		while (this->_next != this->_end)
+		{
+			const char* const line = this->_next;
+			const char* p = line;
+			const char* const eol = static_cast<const char*>(
+				std::memchr(p, '\n', size_t(this->_end - p)));
+			const char* const end = eol ? eol : this->_end;
+			const char* message = NULL;
+
+			this->_next = eol ? eol + 1 : this->_end;
+			skip_blanks(p, end);
+			if (p == end || '#' == *p)
+			{
+				continue;
+			}
+			if (!dataset::parse_fen(p, end, sample, message))
+			{
+				this->fail(size_t(line - this->_begin), message);
+				continue;
+			}
+
+			skip_blanks(p, end);
+			sample.result = -1;
+			sample.score = packed::no_score;
+			if (p != end &&
+				(sample.result = dataset::parse_result(p, end)) < 0)
+			{
+				this->fail(size_t(line - this->_begin), "bad result");
+				continue;
+			}
+			return true;
+		}
+		return false;
+	}
+
+	bool dataset::next_game(sample& sample)
+	{
+		while (!this->_playing)
+		{
+			this->_start = this->_buffer->offset();
+			while (this->_start < this->_length &&
+				is_blank(this->_begin[this->_start]))
+			{
+				++this->_start;
+			}
+			if (!this->_reader->next(*this->_game))
+			{
+				return false;
+			}
+
+			this->_board = board();
+			if (!this->_game->fen.empty())
+			{
+				const char* p = this->_game->fen.data();
+				const char* const end = p + this->_game->fen.size();
+				const char* message = NULL;
+
+				if (!dataset::parse_fen(p, end, sample, message))
+				{
+					this->fail(this->_start, message);
+					continue;
+				}
+				this->_board = dataset::to_board(sample);
+			}
+			this->_turn = 0;
+			this->_playing = true;
+		}
+
+		sample.black = this->_board.get_black_pieces().bits();
+		sample.white = this->_board.get_white_pieces().bits();
+		sample.kings = this->_board.get_kings().bits();
+		sample.black_to_move = this->_board.is_black_to_move();
+		sample.result = this->_game->result;
+		sample.score = packed::no_score;
+
+		std::vector<move> turn;
+		if (this->_turn == this->_game->turns.size())
+		{
+			this->_playing = false;
+		}
+		else if (pdn::parse_turn(this->_board,
+			this->_game->turns[this->_turn], turn))
+		{
+			for (std::vector<move>::const_iterator pos = turn.begin();
+				pos != turn.end(); ++pos)
+			{
+				this->_board.make_move(*pos);
+			}
+			++this->_turn;
+		}
+		else
+		{
+			this->fail(this->_start, "illegal turn");
+			this->_playing = false;
+		}
+		return true;
+	}
+
+	bool dataset::next_record(sample& sample)
+	{
+		if (this->_index == this->_packed->size())
+		{
+			return false;
+		}
+
+		const packed::record& record = (*this->_packed)[this->_index++];
+		sample.black = record.black;
+		sample.white = record.white;
+		sample.kings = record.kings;
+		sample.black_to_move = 0 != record.black_to_move;
+		sample.result = record.result;
+		sample.score = record.score;
+		return true;
+	}
+
+	/**  The lines are counted from the previous error on, the offsets
+	 *   of the errors only grow.
+	 */
+	void dataset::fail(size_t offset, const char* message)
+	{
+		this->_line += size_t(std::count(this->_begin + this->_counted,
+			this->_begin + offset, '\n'));
+		this->_counted = offset;
+
+		const error error = { this->_line, offset, message };
+		this->_errors.push_back(error);
+	}
+}
+
+// End of file
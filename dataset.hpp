@@ -0,0 +1,185 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file dataset.hpp
+ *  @brief Streaming reader of datasets of positions.
+ */
+
+#ifndef __DATASET_HPP__
+#define __DATASET_HPP__
+
+extern "C"
+{
+	#include <stddef.h>
+	#include <stdint.h>
+}
+#include <istream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "board.hpp"
+#include "packed.hpp"
+#include "pdn.hpp"
+
+namespace checkers
+{
+	/** @class dataset
+	 *  @brief Read the positions of a dataset one by one, from a file
+	 *   mapped into memory, so that a large dataset is neither copied
+	 *   nor all in memory.
+	 *
+	 *   A dataset is either a file of lines of a FEN and a result, as
+	 *   "1-0", "0-1", "1/2-1/2", or 1, 0.5 and 0, or a file of games
+	 *   in Portable Draughts Notation, found by its first character
+	 *   '['.  Of a line, empty lines and lines beginning with '#' are
+	 *   skipped, and the result may be left out.  Of a game, every
+	 *   position from the beginning to the end is read, with the
+	 *   result of the game.
+	 *
+	 *   A packed dataset, found by its magic, is read record by
+	 *   record.
+	 *
+	 *   A bad line or game does not stop the reading, it is recorded
+	 *   as an error and skipped.  A game is read up to its first
+	 *   illegal turn.
+	 */
+	class dataset
+	{
+	public:
+		/// A position of the dataset.
+		struct sample
+		{
+			uint32_t black;
+			uint32_t white;
+			uint32_t kings;
+			bool black_to_move;
+			/// The result in half points for Black, -1 when unknown.
+			int result;
+			/** @brief Value of the position for the player to move,
+			 *   packed::no_score when unknown.
+			 */
+			int score;
+		};
+
+		/// A line or game which could not be read.
+		struct error
+		{
+			/// Number of the line from 1, where a game begins.
+			size_t line;
+			/// Offset of the line from the beginning of the file.
+			size_t offset;
+			const char* message;
+		};
+
+		/** @brief Map @e filename into memory.
+		 *  @throw std::runtime_error when the file cannot be read.
+		 */
+		explicit dataset(const std::string& filename);
+		~dataset(void);
+
+		/** @brief Read the next position.
+		 *  @return false at the end of the file.
+		 */
+		bool next(sample& sample);
+		/// Whether the file holds games rather than lines.
+		inline bool is_pdn(void) const;
+		/// Whether the file is a packed dataset.
+		inline bool is_packed(void) const;
+		/// Get the lines and games which could not be read so far.
+		inline const std::vector<error>& get_errors(void) const;
+
+		/// Get the board of @e sample.
+		inline static board to_board(const sample& sample);
+		/** @brief Read a FEN from @e p up to a blank or @e end into
+		 *   @e sample, without throwing and without copying.
+		 *  @param p Moved past the FEN, or to the bad character.
+		 *  @param message Why the FEN is bad, when it is.
+		 *  @return Whether a FEN is read.
+		 */
+		static bool parse_fen(const char*& p, const char* end,
+			sample& sample, const char*& message);
+		/** @brief Read a result from @e p up to a blank or @e end,
+		 *   maybe in brackets or quotes.
+		 *  @param p Moved past the result.
+		 *  @return The result in half points for Black, or -1 when
+		 *   it is no result.
+		 */
+		static int parse_result(const char*& p, const char* end);
+
+	private:
+		/// A stream buffer over the mapped file, for the PDN reader.
+		class buffer : public std::streambuf
+		{
+		public:
+			buffer(const char* begin, const char* end);
+			/// Get the offset of the next character.
+			inline size_t offset(void) const;
+		};
+
+		dataset(const dataset&);
+		dataset& operator =(const dataset&);
+
+		/// Read the next position of a file of lines.
+		bool next_line(sample& sample);
+		/// Read the next position of a file of games.
+		bool next_game(sample& sample);
+		/// Read the next position of a packed dataset.
+		bool next_record(sample& sample);
+		/// Record an error of the line beginning at @e offset.
+		void fail(size_t offset, const char* message);
+
+		/// The file mapped into memory, or NULL when empty.
+		void* _map;
+		size_t _length;
+		const char* _begin;
+		const char* _end;
+		/// The next line to read.
+		const char* _next;
+		/** @brief Number of the line at the offset @e _counted, the
+		 *   lines are counted only for the errors.
+		 */
+		size_t _line;
+		size_t _counted;
+		bool _pdn;
+
+		buffer* _buffer;
+		std::istream* _stream;
+		pdn* _reader;
+		/// The game being read, and the number of its next turn.
+		pdn::game* _game;
+		size_t _turn;
+		/// Offset of the beginning of the game.
+		size_t _start;
+		bool _playing;
+		board _board;
+
+		/// The packed dataset, and the index of its next record.
+		packed* _packed;
+		uint64_t _index;
+
+		std::vector<error> _errors;
+	};
+}
+
+#include "dataset_i.hpp"
+#endif // __DATASET_HPP__
+// End of file
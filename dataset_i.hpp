@@ -0,0 +1,64 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file dataset_i.hpp
+ *  @brief Streaming reader of datasets of positions.
+ */
+
+#ifndef __DATASET_I_HPP__
+#define __DATASET_I_HPP__
+
+namespace checkers
+{
+	inline bool dataset::is_pdn(void) const
+	{
+		return this->_pdn;
+	}
+
+	inline bool dataset::is_packed(void) const
+	{
+		return NULL != this->_packed;
+	}
+
+	inline const std::vector<dataset::error>& dataset::get_errors(void)
+		const
+	{
+		return this->_errors;
+	}
+
+	inline board dataset::to_board(const sample& sample)
+	{
+		return board(bitboard(sample.black), bitboard(sample.white),
+			bitboard(sample.kings),
+			sample.black_to_move ? board::BLACK : board::WHITE);
+	}
+
+	// ================================================================
+
+	inline size_t dataset::buffer::offset(void) const
+	{
+		return size_t(this->gptr() - this->eback());
+	}
+}
+
+#endif // __DATASET_I_HPP__
+// End of file
@@ -0,0 +1,122 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file egdb-gen.cpp
+ *  @brief Generate the endgame databases.
+ */
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include "retrograde.hpp"
+
+void usage(void)
+{
+	std::cerr
+		<< "Usage: egdb-gen [--threads N] [--pieces N] [--distances]"
+		<< " FILE\n"
+		<< "\n"
+		<< "Solve all the positions with up to N pieces, 4 by default,"
+		<< " and write the\n"
+		<< "databases of won, lost and drawn positions to FILE.  With"
+		<< " --distances,\n"
+		<< "write the number of turns to the end of the game of each"
+		<< " position.\n"
+		<< std::flush;
+}
+
+int main(int argc, char* argv[])
+{
+	try
+	{
+		std::string filename;
+		unsigned int threads = 1;
+		unsigned int pieces = 4;
+		bool distances = false;
+		int i = 0;
+
+		while (++i < argc)
+		{
+			const std::string arg(argv[i]);
+
+			if (("--threads" == arg || "--pieces" == arg) &&
+				i + 1 >= argc)
+			{
+				usage();
+				std::exit(255);
+			}
+			if ("--threads" == arg)
+			{
+				threads = std::strtoul(argv[++i], NULL, 10);
+			}
+			else if ("--pieces" == arg)
+			{
+				pieces = std::strtoul(argv[++i], NULL, 10);
+			}
+			else if ("--distances" == arg)
+			{
+				distances = true;
+			}
+			else if ('-' == arg[0] || !filename.empty())
+			{
+				usage();
+				std::exit(255);
+			}
+			else
+			{
+				filename = arg;
+			}
+		}
+		if (filename.empty() || pieces < 2 ||
+			pieces > checkers::egdb::max_pieces)
+		{
+			usage();
+			std::exit(255);
+		}
+
+		checkers::retrograde retrograde(threads, distances);
+		std::cout << std::setw(10) << "slice"
+			<< std::setw(12) << "positions"
+			<< std::setw(12) << "wins"
+			<< std::setw(12) << "losses"
+			<< std::setw(12) << "draws"
+			<< std::setw(7) << "passes"
+			<< std::setw(10) << "time";
+		if (distances)
+		{
+			std::cout << std::setw(9) << "longest";
+		}
+		std::cout << '\n';
+		retrograde.solve(pieces, std::cout);
+		retrograde.save(filename);
+	}
+	catch (std::exception& e)
+	{
+		std::cerr << "Fatal error: " << e.what() << std::endl;
+		std::exit(255);
+	}
+
+	return 0;
+}
+
+// End of file
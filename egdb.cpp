@@ -0,0 +1,610 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file egdb.cpp
+ *  @brief Endgame databases of won, lost and drawn positions.
+ */
+
+extern "C"
+{
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+}
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include "egdb.hpp"
+#include "stats.hpp"
+
+namespace checkers
+{
+	namespace
+	{
+		const char MAGIC[4] = { 'E', 'G', 'D', 'B' };
+		/// The squares of black men, all but the kings row of Black.
+		const uint32_t BLACK_MEN = ~bitboard::BLACK_KINGS_ROW;
+		/// The squares of white men, all but the kings row of White.
+		const uint32_t WHITE_MEN = ~bitboard::WHITE_KINGS_ROW;
+		/// Number of the squares of the men of either color.
+		const unsigned int MEN_SQUARES = 28;
+		/** @brief Number of the 32-bit words of the header after the
+		 *   magic, the last of them padding so that the 64-bit
+		 *   offsets after the slices are aligned.
+		 */
+		const unsigned int HEADER = 7;
+		/// Number of a block not in the cache.
+		const uint32_t NONE = 0xffffffffU;
+
+		/** @brief Number of the blocks of a table of @e size indexes,
+		 *   of distances when @e distances.
+		 */
+		inline uint32_t count_blocks(uint64_t size, bool distances)
+		{
+			return uint32_t(((distances ? size : (size + 3) / 4) +
+				egdb::block_size - 1) / egdb::block_size);
+		}
+
+		/** @brief Compress @e size bytes of @e in to the end of
+		 *   @e out, by PackBits: a byte n up to 127 is followed by
+		 *   n + 1 bytes as they are, and a byte n from 129 is followed
+		 *   by a byte repeated 257 - n times.
+		 */
+		void compress(const uint8_t* in, size_t size,
+			std::vector<uint8_t>& out)
+		{
+			size_t i = 0;
+
+			while (i < size)
+			{
+				size_t run = 1;
+
+				while (i + run < size && run < 128 &&
+					in[i + run] == in[i])
+				{
+					++run;
+				}
+				if (run >= 3)
+				{
+					out.push_back(uint8_t(257 - run));
+					out.push_back(in[i]);
+					i += run;
+					continue;
+				}
+
+				// Bytes as they are, up to the next run of 3.
+				const size_t begin = i;
+				while (i < size && i - begin < 128 &&
+					!(i + 2 < size && in[i] == in[i + 1] &&
+					in[i] == in[i + 2]))
+				{
+					++i;
+				}
+				out.push_back(uint8_t(i - begin - 1));
+				out.insert(out.end(), in + begin, in + i);
+			}
+		}
+
+		/** @brief Decompress @e in up to @e end into at most @e size
+		 *   bytes of @e out.
+		 */
+		inline void decompress(const uint8_t* in, const uint8_t* end,
+			uint8_t* out, size_t size)
+		{
+			uint8_t* const last = out + size;
+
+			while (in < end && out < last)
+			{
+				const unsigned int n = *in++;
+
+				if (n < 128)
+				{
+					const size_t count = std::min(size_t(n + 1),
+						size_t(std::min(end - in, last - out)));
+
+					std::memcpy(out, in, count);
+					in += count;
+					out += count;
+				}
+				else if (n > 128 && in < end)
+				{
+					const size_t count = std::min(size_t(257 - n),
+						size_t(last - out));
+
+					std::memset(out, *in++, count);
+					out += count;
+				}
+			}
+		}
+	}
+
+	/**  The databases of a previous file are closed first, also when
+	 *   the new file is bad.
+	 *  @param megabytes At least one block is cached.
+	 */
+	void egdb::open(const std::string& filename, unsigned int megabytes)
+	{
+		egdb::close();
+
+		const int fd = ::open(filename.c_str(), O_RDONLY);
+		struct stat status;
+
+		if (fd < 0 || fstat(fd, &status) < 0)
+		{
+			if (fd >= 0)
+			{
+				::close(fd);
+			}
+			/// @throw std::runtime_error when the file cannot be
+			///  opened.
+			throw std::runtime_error(
+				"Error (cannot open endgame database): " +
+				filename);
+		}
+		egdb::_length = status.st_size;
+		egdb::_map = egdb::_length ? mmap(NULL, egdb::_length,
+			PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+		::close(fd);
+		if (MAP_FAILED == egdb::_map)
+		{
+			egdb::_map = NULL;
+			/// @throw std::runtime_error when the file cannot be
+			///  mapped.
+			throw std::runtime_error(
+				"Error (cannot map endgame database): " +
+				filename);
+		}
+		madvise(egdb::_map, egdb::_length, MADV_RANDOM);
+
+		// The header, the slices, the offsets of the blocks.
+		const uint8_t* const map = static_cast<uint8_t*>(egdb::_map);
+		const uint32_t* const header =
+			reinterpret_cast<const uint32_t*>(map + sizeof(MAGIC));
+		uint64_t size = sizeof(MAGIC) + HEADER * sizeof(uint32_t);
+		bool good = egdb::_length >= size &&
+			0 == std::memcmp(map, MAGIC, sizeof(MAGIC)) &&
+			egdb::version == header[0] &&
+			header[1] <= egdb::max_pieces && header[2] <= 1 &&
+			egdb::block_size == header[4] && 0 == header[6];
+		const uint32_t slices = good ? header[3] : 0;
+		const uint32_t blocks = good ? header[5] : 0;
+		const uint32_t* const counts = header + HEADER;
+		uint32_t first = 0;
+
+		size += uint64_t(slices) * 4 * sizeof(uint32_t) +
+			(uint64_t(blocks) + 1) * sizeof(uint64_t);
+		good = good && slices <= egdb::keys && egdb::_length >= size;
+		egdb::_indexes.assign(egdb::keys, -1);
+		for (uint32_t i = 0; good && i < slices; ++i)
+		{
+			const slice slice =
+			{
+				counts[4 * i], counts[4 * i + 1],
+				counts[4 * i + 2], counts[4 * i + 3]
+			};
+
+			good = slice.black_men <= header[1] &&
+				slice.black_kings <= header[1] &&
+				slice.white_men <= header[1] &&
+				slice.white_kings <= header[1] &&
+				slice.pieces() <= header[1] &&
+				slice.black_men + slice.black_kings &&
+				slice.white_men + slice.white_kings &&
+				-1 == egdb::_indexes[egdb::key(slice)];
+			if (good)
+			{
+				const table table =
+				{
+					slice, egdb::size(slice), first
+				};
+
+				egdb::_indexes[egdb::key(slice)] =
+					int(egdb::_contents.size());
+				egdb::_contents.push_back(table);
+				first += count_blocks(table._size,
+					0 != header[2]);
+			}
+		}
+
+		egdb::_offsets = reinterpret_cast<const uint64_t*>(
+			counts + 4 * slices);
+		egdb::_data = reinterpret_cast<const uint8_t*>(
+			egdb::_offsets + blocks + 1);
+		good = good && first == blocks &&
+			egdb::_offsets[blocks] == egdb::_length - size;
+		for (uint32_t i = 0; good && i < blocks; ++i)
+		{
+			good = egdb::_offsets[i] <= egdb::_offsets[i + 1];
+		}
+		if (!good)
+		{
+			egdb::close();
+			/// @throw std::runtime_error when the file is not a
+			///  database, or is cut short.
+			throw std::runtime_error(
+				"Error (bad endgame database): " + filename);
+		}
+
+		const uint32_t slots = std::max(1U,
+			std::min(megabytes, unsigned(egdb::max_cache_size)) *
+			(1024 * 1024 / egdb::block_size));
+		const block unused = { NONE, 0, 0 };
+		egdb::_cache.assign(slots + 1, unused);
+		for (uint32_t i = 0; i <= slots; ++i)
+		{
+			egdb::_cache[i]._prev = (i + slots) % (slots + 1);
+			egdb::_cache[i]._next = (i + 1) % (slots + 1);
+		}
+		egdb::_cache_data.assign(size_t(slots) * egdb::block_size, 0);
+		egdb::_slots.assign(blocks, 0);
+		egdb::_pieces = header[1];
+		egdb::_distances = 0 != header[2];
+	}
+
+	void egdb::close(void)
+	{
+		if (egdb::_map)
+		{
+			munmap(egdb::_map, egdb::_length);
+		}
+		egdb::_map = NULL;
+		egdb::_length = 0;
+		egdb::_pieces = 0;
+		egdb::_distances = false;
+		egdb::_contents.clear();
+		egdb::_indexes.clear();
+		egdb::_offsets = NULL;
+		egdb::_data = NULL;
+		std::vector<block>().swap(egdb::_cache);
+		std::vector<uint8_t>().swap(egdb::_cache_data);
+		std::vector<uint32_t>().swap(egdb::_slots);
+	}
+
+	/**  The positions with a player without pieces are not in the
+	 *   databases, as the game is over.
+	 */
+	bool egdb::probe(const board& board, value& value,
+		unsigned int& distance)
+	{
+		uint32_t black;
+		uint32_t white;
+		uint32_t kings;
+
+		if (board.get_occupied().count() > egdb::_pieces)
+		{
+			return false;
+		}
+		stats::add(stats::EGDB_PROBES);
+		egdb::orient(board, black, white, kings);
+
+		const slice slice = egdb::get_slice(black, white, kings);
+		const int n = black && white ?
+			egdb::_indexes[egdb::key(slice)] : -1;
+		if (n < 0)
+		{
+			return false;
+		}
+
+		const table& table = egdb::_contents[n];
+		const uint64_t index = egdb::index(slice, black, white, kings);
+		const uint64_t offset = egdb::_distances ? index : index >> 2;
+		const uint8_t byte = egdb::load(table._first +
+			uint32_t(offset / egdb::block_size))[
+				offset % egdb::block_size];
+
+		if (egdb::_distances)
+		{
+			value = egdb::decode(byte);
+			distance = egdb::no_distance == byte ? 0 : byte;
+		}
+		else
+		{
+			value = egdb::value((byte >> (2 * (index & 3))) & 3);
+			distance = 0;
+		}
+		stats::add(stats::EGDB_HITS);
+		return true;
+	}
+
+	/**  A drawn position is left to the search, which also looks for
+	 *   the mistakes of the opponent.
+	 *  @param turn The moves of the turn chosen, the jumps of a
+	 *   multiple jump one by one.
+	 *  @param distance The distance of @e board.
+	 */
+	bool egdb::choose(board& board, std::vector<move>& turn,
+		value& value, unsigned int& distance)
+	{
+		turn.clear();
+		if (!egdb::_distances || !egdb::probe(board, value, distance) ||
+			egdb::DRAW == value)
+		{
+			return false;
+		}
+
+		std::vector<move> moves;
+		unsigned int best = 0;
+
+		egdb::choose(board, bitboard(bitboard::EMPTY),
+			egdb::WIN == value, moves, turn, best);
+		return !turn.empty();
+	}
+
+	uint64_t egdb::size(const slice& slice)
+	{
+		const unsigned int men = slice.black_men + slice.white_men;
+
+		return egdb::_binomials[MEN_SQUARES][slice.black_men] *
+			egdb::_binomials[MEN_SQUARES][slice.white_men] *
+			egdb::_binomials[32 - men][slice.black_kings] *
+			egdb::_binomials[32 - men - slice.black_kings][
+				slice.white_kings];
+	}
+
+	uint64_t egdb::index(const slice& slice, uint32_t black,
+		uint32_t white, uint32_t kings)
+	{
+		const unsigned int men = slice.black_men + slice.white_men;
+		uint32_t unoccupied = ~((black | white) & ~kings);
+		uint64_t index;
+
+		index = egdb::rank(black & ~kings, BLACK_MEN);
+		index = index * egdb::_binomials[MEN_SQUARES][slice.white_men] +
+			egdb::rank(white & ~kings, WHITE_MEN);
+		index = index * egdb::_binomials[32 - men][slice.black_kings] +
+			egdb::rank(black & kings, unoccupied);
+		unoccupied &= ~(black & kings);
+		index = index * egdb::_binomials[32 - men - slice.black_kings][
+				slice.white_kings] +
+			egdb::rank(white & kings, unoccupied);
+		return index;
+	}
+
+	bool egdb::position(const slice& slice, uint64_t index,
+		uint32_t& black, uint32_t& white, uint32_t& kings)
+	{
+		const unsigned int men = slice.black_men + slice.white_men;
+		const uint64_t white_kings =
+			egdb::_binomials[32 - men - slice.black_kings][
+				slice.white_kings];
+		const uint64_t black_kings =
+			egdb::_binomials[32 - men][slice.black_kings];
+		const uint64_t white_men =
+			egdb::_binomials[MEN_SQUARES][slice.white_men];
+		const uint64_t white_kings_rank = index % white_kings;
+		const uint64_t black_kings_rank = index / white_kings %
+			black_kings;
+		const uint64_t white_men_rank = index / white_kings /
+			black_kings % white_men;
+		const uint64_t black_men_rank = index / white_kings /
+			black_kings / white_men;
+
+		black = egdb::unrank(black_men_rank, slice.black_men, BLACK_MEN);
+		white = egdb::unrank(white_men_rank, slice.white_men, WHITE_MEN);
+		if (black & white)
+		{
+			return false;
+		}
+
+		uint32_t unoccupied = ~(black | white);
+		const uint32_t black_kings_squares = egdb::unrank(
+			black_kings_rank, slice.black_kings, unoccupied);
+		unoccupied &= ~black_kings_squares;
+		const uint32_t white_kings_squares = egdb::unrank(
+			white_kings_rank, slice.white_kings, unoccupied);
+
+		kings = black_kings_squares | white_kings_squares;
+		black |= black_kings_squares;
+		white |= white_kings_squares;
+		return true;
+	}
+
+	/**  For example "2m1k-0m2k" for 2 black men and a black king
+	 *   against 2 white kings.
+	 */
+	std::string egdb::name(const slice& slice)
+	{
+		std::ostringstream name;
+
+		name << slice.black_men << 'm' << slice.black_kings << "k-" <<
+			slice.white_men << 'm' << slice.white_kings << 'k';
+		return name.str();
+	}
+
+	/**  The file begins with the magic "EGDB", the version, the
+	 *   maximum number of pieces, 1 for distances or 0 for values, the
+	 *   number of slices, the size of the blocks, the number of blocks
+	 *   and 0, then the numbers of black men, black kings, white men
+	 *   and white kings of each slice, all 32-bit.  The header is 32
+	 *   bytes and a slice 16, so the 64-bit offsets that follow are
+	 *   aligned in the mapped file.  They are the offsets of the blocks
+	 *   from the end of the offsets, and the offset of the end of the
+	 *   file, then the compressed blocks of the tables come in the
+	 *   same order.
+	 */
+	void egdb::save(const std::string& filename, unsigned int pieces,
+		bool distances, const std::vector<slice>& slices,
+		const std::vector<std::vector<uint8_t> >& tables)
+	{
+		std::ofstream file(filename.c_str(),
+			std::ios::out | std::ios::binary | std::ios::trunc);
+		std::vector<uint64_t> offsets(1, 0);
+		std::vector<uint8_t> data;
+
+		for (std::vector<std::vector<uint8_t> >::const_iterator pos =
+			tables.begin(); pos != tables.end(); ++pos)
+		{
+			for (size_t i = 0; i < pos->size(); i += egdb::block_size)
+			{
+				compress(&(*pos)[i], std::min(pos->size() - i,
+					size_t(egdb::block_size)), data);
+				offsets.push_back(data.size());
+			}
+		}
+
+		const uint32_t header[HEADER] =
+		{
+			egdb::version, pieces, distances,
+			uint32_t(slices.size()), egdb::block_size,
+			uint32_t(offsets.size() - 1), 0
+		};
+
+		file.write(MAGIC, sizeof(MAGIC));
+		file.write(reinterpret_cast<const char*>(header),
+			sizeof(header));
+		for (std::vector<slice>::const_iterator pos = slices.begin();
+			pos != slices.end(); ++pos)
+		{
+			const uint32_t counts[4] =
+			{
+				pos->black_men, pos->black_kings,
+				pos->white_men, pos->white_kings
+			};
+
+			file.write(reinterpret_cast<const char*>(counts),
+				sizeof(counts));
+		}
+		file.write(reinterpret_cast<const char*>(&offsets[0]),
+			offsets.size() * sizeof(offsets[0]));
+		file.write(reinterpret_cast<const char*>(&data[0]),
+			data.size());
+		file.close();
+		if (!file)
+		{
+			/// @throw std::runtime_error when the file cannot be
+			///  written.
+			throw std::runtime_error(
+				"Error (cannot write endgame database): " +
+				filename);
+		}
+	}
+
+	/**  The distances of the positions after the turn are those of the
+	 *   opponent.  A position without pieces is not in the databases,
+	 *   and is lost at once, while a position of a slice missing from
+	 *   the databases is skipped.
+	 *  @param win Whether @e board is won, then the turn leading to
+	 *   the nearest loss of the opponent is chosen, otherwise the one
+	 *   to the farthest win.
+	 */
+	void egdb::choose(board& board, bitboard jumper, bool win,
+		std::vector<move>& moves, std::vector<move>& turn,
+		unsigned int& distance)
+	{
+		const std::vector<move> next = jumper ?
+			board.generate_jumps(jumper) : board.generate_moves();
+
+		for (std::vector<move>::const_iterator pos = next.begin();
+			pos != next.end(); ++pos)
+		{
+			moves.push_back(*pos);
+			if (board.make_move(*pos))
+			{
+				egdb::choose(board, pos->get_dest(), win, moves,
+					turn, distance);
+			}
+			else
+			{
+				value value = egdb::UNKNOWN;
+				unsigned int d = 0;
+
+				if (!egdb::probe(board, value, d) &&
+					!(board.is_black_to_move() ?
+					board.get_black_pieces() :
+					board.get_white_pieces()))
+				{
+					value = egdb::LOSS;
+				}
+				if ((win ? egdb::LOSS : egdb::WIN) == value &&
+					(turn.empty() || (win ? d < distance :
+					d > distance)))
+				{
+					turn = moves;
+					distance = d;
+				}
+			}
+			board.undo_move(*pos);
+			moves.pop_back();
+		}
+	}
+
+	/**  A block not in the cache takes the place of the least recently
+	 *   used one.
+	 */
+	const uint8_t* egdb::load(uint32_t number)
+	{
+		uint32_t slot = egdb::_slots[number];
+
+		if (!slot)
+		{
+			stats::add(stats::EGDB_LOADS);
+			slot = egdb::_cache[0]._prev;
+			if (NONE != egdb::_cache[slot]._number)
+			{
+				egdb::_slots[egdb::_cache[slot]._number] = 0;
+			}
+			decompress(egdb::_data + egdb::_offsets[number],
+				egdb::_data + egdb::_offsets[number + 1],
+				&egdb::_cache_data[size_t(slot - 1) *
+					egdb::block_size], egdb::block_size);
+			egdb::_cache[slot]._number = number;
+			egdb::_slots[number] = slot;
+		}
+		egdb::touch(slot);
+		return &egdb::_cache_data[size_t(slot - 1) * egdb::block_size];
+	}
+
+	bool egdb::build_tables(void)
+	{
+		for (unsigned int n = 0; n <= 32; ++n)
+		{
+			egdb::_binomials[n][0] = 1;
+			for (unsigned int k = 1; k <= 32; ++k)
+			{
+				egdb::_binomials[n][k] = 0 == n ? 0 :
+					egdb::_binomials[n - 1][k - 1] +
+					egdb::_binomials[n - 1][k];
+			}
+		}
+		return true;
+	}
+
+	const uint8_t egdb::no_distance;
+	void* egdb::_map = NULL;
+	size_t egdb::_length = 0;
+	unsigned int egdb::_pieces = 0;
+	bool egdb::_distances = false;
+	std::vector<egdb::table> egdb::_contents;
+	std::vector<int> egdb::_indexes;
+	const uint64_t* egdb::_offsets = NULL;
+	const uint8_t* egdb::_data = NULL;
+	std::vector<egdb::block> egdb::_cache;
+	std::vector<uint8_t> egdb::_cache_data;
+	std::vector<uint32_t> egdb::_slots;
+	uint64_t egdb::_binomials[33][33];
+	const bool egdb::_tables = egdb::build_tables();
+}
+
+// End of file
@@ -0,0 +1,275 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file egdb.hpp
+ *  @brief Endgame databases of won, lost and drawn positions.
+ */
+
+#ifndef __EGDB_HPP__
+#define __EGDB_HPP__
+
+extern "C"
+{
+	#include <stddef.h>
+	#include <stdint.h>
+}
+#include <string>
+#include <vector>
+#include "board.hpp"
+
+namespace checkers
+{
+	/** @class egdb
+	 *  @brief Endgame databases, the value of every position with few
+	 *   pieces for the player to move.
+	 *
+	 *   The positions are kept with the player to move as Black, a
+	 *   position with White to move is turned around first: square s
+	 *   becomes 31 - s and the colors swap.
+	 *
+	 *   The positions are split into slices by the numbers of black
+	 *   men, black kings, white men and white kings.  Inside a slice a
+	 *   position is indexed by ranking the squares of each kind of
+	 *   piece among the squares left to it: the black men among the
+	 *   squares 1 to 28, the white men among 5 to 32, the black kings
+	 *   among the squares without men, and the white kings among the
+	 *   squares left.  The index is dense, but for the positions where
+	 *   the men of both colors overlap, which do not exist and take
+	 *   the value before them.
+	 *
+	 *   The values take 2 bits each, 4 positions to a byte.  On disk
+	 *   the tables are cut into blocks of 4 KB, each compressed by
+	 *   runs of equal bytes, and an index of the blocks follows the
+	 *   header.  The file is mapped into memory, and the blocks are
+	 *   decompressed on demand into a cache, which drops the least
+	 *   recently used block first.  The cache is not locked, the probes
+	 *   are made by one thread.
+	 *
+	 *   Instead of the values, the databases may hold the distance of
+	 *   each position, the number of turns to the end of the game, a
+	 *   byte each.  A won position is an odd number of turns from the
+	 *   end and a lost one an even number, and a drawn one is
+	 *   no_distance.
+	 */
+	class egdb
+	{
+	public:
+		/// Value of a position for the player to move.
+		enum value
+		{
+			/// Not known yet.
+			UNKNOWN,
+			WIN,
+			LOSS,
+			DRAW
+		};
+
+		/// The numbers of each kind of piece.
+		struct slice
+		{
+			unsigned int black_men;
+			unsigned int black_kings;
+			unsigned int white_men;
+			unsigned int white_kings;
+
+			inline unsigned int pieces(void) const;
+			/// The same numbers with the colors swapped.
+			inline slice mirror(void) const;
+			inline bool operator ==(const slice& rhs) const;
+		};
+
+		/// Maximum number of pieces on the board of a database.
+		static const unsigned int max_pieces = 8;
+		/// Version of the database file.
+		static const uint32_t version = 4;
+		/// Bytes of a table in a block, before compression.
+		static const unsigned int block_size = 4096;
+		/// Default size of the cache of blocks in megabytes.
+		static const unsigned int cache_size = 16;
+		/// Largest size of the cache of blocks in megabytes.
+		static const unsigned int max_cache_size = 1024;
+		/// Longest distance of a won or lost position.
+		static const unsigned int max_distance = 254;
+		/// Distance of a drawn position.
+		static const uint8_t no_distance = 255;
+
+		/** @brief Map the databases of @e filename into memory, with
+		 *   a cache of @e megabytes of blocks, at most
+		 *   @e max_cache_size.
+		 */
+		static void open(const std::string& filename,
+			unsigned int megabytes = egdb::cache_size);
+		/// Unmap the databases.
+		static void close(void);
+		/** @brief Get the maximum number of pieces of the databases,
+		 *   0 when there are none.
+		 */
+		inline static unsigned int get_pieces(void);
+		/// Whether the databases hold the distances.
+		inline static bool has_distances(void);
+		/** @brief Find the value of @e board for the player to move.
+		 *  @return Whether @e board is in the databases.
+		 */
+		inline static bool probe(const board& board, value& value);
+		/** @brief Find the value of @e board for the player to move,
+		 *   and its distance in turns to the end of the game, 0 when
+		 *   drawn or when the databases hold no distances.
+		 *  @return Whether @e board is in the databases.
+		 */
+		static bool probe(const board& board, value& value,
+			unsigned int& distance);
+		/** @brief Choose the turn of the player to move which wins
+		 *   the fastest, or loses the slowest, by the distances.
+		 *  @return Whether @e board is won or lost in the databases
+		 *   with distances.
+		 */
+		static bool choose(board& board, std::vector<move>& turn,
+			value& value, unsigned int& distance);
+
+		/** @brief Get the pieces of @e board with the player to move
+		 *   as Black.
+		 */
+		inline static void orient(const board& board, uint32_t& black,
+			uint32_t& white, uint32_t& kings);
+		/// Turn the squares around, square s becomes 31 - s.
+		inline static uint32_t flip(uint32_t squares);
+		/// Get the slice of a position.
+		inline static slice get_slice(uint32_t black, uint32_t white,
+			uint32_t kings);
+
+		/// Get the number of indexes of @e slice.
+		static uint64_t size(const slice& slice);
+		/// Get the index of a position of @e slice, Black to move.
+		static uint64_t index(const slice& slice, uint32_t black,
+			uint32_t white, uint32_t kings);
+		/** @brief Get the position of @e index in @e slice, Black to
+		 *   move.
+		 *  @return Whether the position exists.
+		 */
+		static bool position(const slice& slice, uint64_t index,
+			uint32_t& black, uint32_t& white, uint32_t& kings);
+		/// Show @e slice as the numbers of men and kings.
+		static std::string name(const slice& slice);
+		/// Get the place of @e slice in a table of all slices.
+		inline static unsigned int key(const slice& slice);
+		/// Number of the places of the table of all slices.
+		static const unsigned int keys = (max_pieces + 1) *
+			(max_pieces + 1) * (max_pieces + 1) * (max_pieces + 1);
+
+		/// Get the value of @e index from a table of 2 bits each.
+		inline static value get(const std::vector<uint8_t>& table,
+			uint64_t index);
+		/// Set the value of @e index in a table of 2 bits each.
+		inline static void set(std::vector<uint8_t>& table,
+			uint64_t index, value value);
+		/// Get the value of a position from its @e distance.
+		inline static value decode(uint8_t distance);
+
+		/** @brief Write the tables of @e slices to @e filename, of
+		 *   distances a byte each when @e distances, otherwise of
+		 *   values 2 bits each.
+		 */
+		static void save(const std::string& filename,
+			unsigned int pieces, bool distances,
+			const std::vector<slice>& slices,
+			const std::vector<std::vector<uint8_t> >& tables);
+
+	private:
+		/// A table of the file.
+		struct table
+		{
+			slice _slice;
+			/// Number of indexes.
+			uint64_t _size;
+			/// Number of the first block.
+			uint32_t _first;
+		};
+
+		/// A block in the cache, linked in the order of use.
+		struct block
+		{
+			/// Number of the block, or none when unused.
+			uint32_t _number;
+			uint32_t _prev;
+			uint32_t _next;
+		};
+
+		/// Get the decompressed data of the block @e number.
+		static const uint8_t* load(uint32_t number);
+		/// Move @e slot to the front of the cache.
+		inline static void touch(uint32_t slot);
+		/** @brief Look through the turns of the player to move, from
+		 *   the piece @e jumper jumping once more if not empty, for a
+		 *   turn better than @e turn at @e distance.
+		 *  @param moves The moves of the turn so far.
+		 */
+		static void choose(board& board, bitboard jumper, bool win,
+			std::vector<move>& moves, std::vector<move>& turn,
+			unsigned int& distance);
+
+		/** @brief Rank the set @e squares among the squares of
+		 *   @e candidates.
+		 */
+		inline static uint64_t rank(uint32_t squares,
+			uint32_t candidates);
+		/** @brief Get the set of @e count squares of @e candidates
+		 *   with @e rank.
+		 */
+		inline static uint32_t unrank(uint64_t rank, unsigned int count,
+			uint32_t candidates);
+		/// Get the @e n-th square of @e candidates, from 0.
+		inline static uint32_t select(unsigned int n,
+			uint32_t candidates);
+
+		/// Fill the table of binomial coefficients.
+		static bool build_tables(void);
+
+		/// The file mapped into memory, or NULL.
+		static void* _map;
+		static size_t _length;
+		static unsigned int _pieces;
+		static bool _distances;
+		/// The tables of the file, in order.
+		static std::vector<table> _contents;
+		/// Place of each slice in _contents, or -1 when not there.
+		static std::vector<int> _indexes;
+		/// Offsets of the blocks from _data, and of the end.
+		static const uint64_t* _offsets;
+		static const uint8_t* _data;
+		/** @brief The blocks in the cache, the first is the head of
+		 *   the list, the most recently used after it.
+		 */
+		static std::vector<block> _cache;
+		static std::vector<uint8_t> _cache_data;
+		/// The slot in the cache of each block, or 0.
+		static std::vector<uint32_t> _slots;
+
+		/// Binomial coefficients, n choose k.
+		static uint64_t _binomials[33][33];
+		/// The table is built during static initialization.
+		static const bool _tables;
+	};
+}
+
+#include "egdb_i.hpp"
+#endif // __EGDB_HPP__
+// End of file
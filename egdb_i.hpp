@@ -0,0 +1,224 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file egdb_i.hpp
+ *  @brief Endgame databases of won, lost and drawn positions.
+ */
+
+#ifndef __EGDB_I_HPP__
+#define __EGDB_I_HPP__
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace checkers
+{
+	inline unsigned int egdb::slice::pieces(void) const
+	{
+		return this->black_men + this->black_kings + this->white_men +
+			this->white_kings;
+	}
+
+	inline egdb::slice egdb::slice::mirror(void) const
+	{
+		const slice mirror =
+		{
+			this->white_men, this->white_kings,
+			this->black_men, this->black_kings
+		};
+
+		return mirror;
+	}
+
+	inline bool egdb::slice::operator ==(const slice& rhs) const
+	{
+		return this->black_men == rhs.black_men &&
+			this->black_kings == rhs.black_kings &&
+			this->white_men == rhs.white_men &&
+			this->white_kings == rhs.white_kings;
+	}
+
+	// ================================================================
+
+	inline unsigned int egdb::get_pieces(void)
+	{
+		return egdb::_pieces;
+	}
+
+	inline bool egdb::has_distances(void)
+	{
+		return egdb::_distances;
+	}
+
+	inline bool egdb::probe(const board& board, value& value)
+	{
+		unsigned int distance;
+
+		return egdb::probe(board, value, distance);
+	}
+
+	inline unsigned int egdb::key(const slice& slice)
+	{
+		const unsigned int n = egdb::max_pieces + 1;
+
+		return ((slice.black_men * n + slice.black_kings) * n +
+			slice.white_men) * n + slice.white_kings;
+	}
+
+	inline void egdb::touch(uint32_t slot)
+	{
+		block& block = egdb::_cache[slot];
+
+		egdb::_cache[block._prev]._next = block._next;
+		egdb::_cache[block._next]._prev = block._prev;
+		block._prev = 0;
+		block._next = egdb::_cache[0]._next;
+		egdb::_cache[block._next]._prev = slot;
+		egdb::_cache[0]._next = slot;
+	}
+
+	inline void egdb::orient(const board& board, uint32_t& black,
+		uint32_t& white, uint32_t& kings)
+	{
+		if (board.is_black_to_move())
+		{
+			black = board.get_black_pieces().bits();
+			white = board.get_white_pieces().bits();
+			kings = board.get_kings().bits();
+		}
+		else
+		{
+			black = egdb::flip(board.get_white_pieces().bits());
+			white = egdb::flip(board.get_black_pieces().bits());
+			kings = egdb::flip(board.get_kings().bits());
+		}
+	}
+
+	/**  Turning the board around is reversing the bits.
+	 */
+	inline uint32_t egdb::flip(uint32_t squares)
+	{
+		squares = ((squares >> 1) & 0x55555555U) |
+			((squares & 0x55555555U) << 1);
+		squares = ((squares >> 2) & 0x33333333U) |
+			((squares & 0x33333333U) << 2);
+		squares = ((squares >> 4) & 0x0f0f0f0fU) |
+			((squares & 0x0f0f0f0fU) << 4);
+		squares = ((squares >> 8) & 0x00ff00ffU) |
+			((squares & 0x00ff00ffU) << 8);
+		return (squares >> 16) | (squares << 16);
+	}
+
+	inline egdb::slice egdb::get_slice(uint32_t black, uint32_t white,
+		uint32_t kings)
+	{
+		const slice slice =
+		{
+			bitboard(black & ~kings).count(),
+			bitboard(black & kings).count(),
+			bitboard(white & ~kings).count(),
+			bitboard(white & kings).count()
+		};
+
+		return slice;
+	}
+
+	inline egdb::value egdb::get(const std::vector<uint8_t>& table,
+		uint64_t index)
+	{
+		return value((table[index >> 2] >> (2 * (index & 3))) & 3);
+	}
+
+	inline void egdb::set(std::vector<uint8_t>& table, uint64_t index,
+		value value)
+	{
+		uint8_t& byte = table[index >> 2];
+
+		byte = uint8_t((byte & ~(3 << (2 * (index & 3)))) |
+			(value << (2 * (index & 3))));
+	}
+
+	inline egdb::value egdb::decode(uint8_t distance)
+	{
+		return egdb::no_distance == distance ? DRAW :
+			distance & 1 ? WIN : LOSS;
+	}
+
+	/**  The k-th lowest square, counted from 1, at the n-th place
+	 *   among the candidates adds n choose k, which numbers the sets of
+	 *   a size from 0 without gaps.
+	 */
+	inline uint64_t egdb::rank(uint32_t squares, uint32_t candidates)
+	{
+		uint64_t rank = 0;
+		unsigned int k = 1;
+
+		for (bitboard rest(squares); rest; ++k)
+		{
+			const bitboard square = rest.lsb();
+
+			rest ^= square;
+			rank += egdb::_binomials[bitboard(candidates &
+				(square.bits() - 1)).count()][k];
+		}
+		return rank;
+	}
+
+	inline uint32_t egdb::unrank(uint64_t rank, unsigned int count,
+		uint32_t candidates)
+	{
+		uint32_t squares = 0;
+		unsigned int n = bitboard(candidates).count();
+
+		for (unsigned int k = count; k > 0; --k)
+		{
+			do
+			{
+				--n;
+			}
+			while (egdb::_binomials[n][k] > rank);
+			rank -= egdb::_binomials[n][k];
+			squares |= egdb::select(n, candidates);
+		}
+		return squares;
+	}
+
+	/**  PDEP with BMI2, otherwise the lowest squares are dropped one
+	 *   by one.
+	 */
+	inline uint32_t egdb::select(unsigned int n, uint32_t candidates)
+	{
+#if defined(__BMI2__)
+		return _pdep_u32(0x1U << n, candidates);
+#else
+		while (n--)
+		{
+			candidates &= candidates - 1;
+		}
+		return candidates & -candidates;
+#endif
+	}
+}
+
+#endif // __EGDB_I_HPP__
+// End of file
@@ -29,23 +29,44 @@ extern "C"
 #include <unistd.h>
 }
 #include <cstdlib>
+#include <stdexcept>
 #include "absearch.hpp"
+#include "bench.hpp"
+#include "book.hpp"
+#include "egdb.hpp"
 #include "engine.hpp"
+#include "mcts.hpp"
+#include "nnue.hpp"
 #include "nonstdio.hpp"
+#include "pattern.hpp"
+#include "perft.hpp"
+#include "stats.hpp"
 
 namespace checkers
 {
   engine::engine(void) :
     _board(), _rotate(false), _history(), _best_moves(),
     _force_mode(false), _depth_limit(UNLIMITED), _time_limit(10),
-    _verbose(false)
+    _verbose(false), _search(ALPHA_BETA), _threads(1)
   {
     this->_action.insert(std::make_pair("?",
 					&engine::do_help));
     this->_action.insert(std::make_pair("analyze",
 					&engine::do_analyze));
+    this->_action.insert(std::make_pair("bench",
+					&engine::do_bench));
     this->_action.insert(std::make_pair("black",
 					&engine::do_black));
+    this->_action.insert(std::make_pair("book",
+					&engine::do_book));
+    this->_action.insert(std::make_pair("divide",
+					&engine::do_divide));
+    this->_action.insert(std::make_pair("egdb",
+					&engine::do_egdb));
+    this->_action.insert(std::make_pair("engine",
+					&engine::do_engine));
+    this->_action.insert(std::make_pair("evalcache",
+					&engine::do_evalcache));
     this->_action.insert(std::make_pair("force",
 					&engine::do_force));
     this->_action.insert(std::make_pair("go",
@@ -56,6 +77,12 @@ namespace checkers
 					&engine::do_history));
     this->_action.insert(std::make_pair("new",
 					&engine::do_new));
+    this->_action.insert(std::make_pair("nnue",
+					&engine::do_nnue));
+    this->_action.insert(std::make_pair("pattern",
+					&engine::do_pattern));
+    this->_action.insert(std::make_pair("perft",
+					&engine::do_perft));
     this->_action.insert(std::make_pair("ping",
 					&engine::do_ping));
     this->_action.insert(std::make_pair("ponder",
@@ -70,12 +97,20 @@ namespace checkers
 					&engine::do_sd));
     this->_action.insert(std::make_pair("st",
 					&engine::do_st));
+    this->_action.insert(std::make_pair("stats",
+					&engine::do_stats));
+    this->_action.insert(std::make_pair("setoption",
+					&engine::do_setoption));
     this->_action.insert(std::make_pair("setboard",
 					&engine::do_setboard));
+    this->_action.insert(std::make_pair("threads",
+					&engine::do_threads));
     this->_action.insert(std::make_pair("undo",
 					&engine::do_undo));
     this->_action.insert(std::make_pair("verbose",
 					&engine::do_verbose));
+    this->_action.insert(std::make_pair("weights",
+					&engine::do_weights));
     this->_action.insert(std::make_pair("white",
 					&engine::do_white));
   }
@@ -351,6 +386,20 @@ namespace checkers
     return ret;
   }
 
+  void engine::think(bool verbose)
+  {
+    if (MONTE_CARLO == this->_search)
+      {
+	mcts::think(this->_best_moves, this->_board,
+		    this->_time_limit, this->_threads, verbose);
+      }
+    else
+      {
+	absearch::think(this->_best_moves, this->_board,
+			this->_depth_limit, this->_time_limit, verbose);
+      }
+  }
+
   void engine::computer_makes_move(void)
   {
     if (this->_force_mode)
@@ -363,23 +412,54 @@ namespace checkers
     //nio << "  Thinking ...\n";
 
     std::vector<move> moves;
-    do
+    book::entry entry;
+    egdb::value value;
+    unsigned int distance;
+    bool known;
+
+    // A turn in the opening book, or with the distances of the endgame
+    // databases the fastest win, is known at once, and the whole turn
+    // is played without a search.
+    if ((known = book::choose(this->_board, moves, entry)) &&
+	this->_verbose)
       {
-	absearch::think(this->_best_moves, this->_board,
-			this->_depth_limit, this->_time_limit,
-			this->_verbose);
-	if (this->_best_moves.empty())
+	nio << "  book weight " << entry.weight << "   wins "
+	    << entry.wins << "   draws " << entry.draws << "   losses "
+	    << entry.losses << '\n';
+      }
+    if (!known && (known = egdb::choose(this->_board, moves, value,
+					distance)) && this->_verbose)
+      {
+	nio << "  egdb " << (egdb::WIN == value ? "win" : "loss")
+	    << " in " << distance << " turns\n";
+      }
+    if (known)
+      {
+	this->_best_moves.clear();
+	for (std::vector<move>::const_iterator pos = moves.begin();
+	     pos != moves.end(); ++pos)
 	  {
-	    break;
+	    this->make_move(*pos);
 	  }
+      }
+    else
+      {
 	do
 	  {
-	    moves.push_back(this->_best_moves.front());
-	    contin = this->make_move(
-				     this->_best_moves.front());
-	    //this->print_board();
-	  } while (contin && !this->_best_moves.empty());
-      } while (contin);
+	    this->think(this->_verbose);
+	    if (this->_best_moves.empty())
+	      {
+		break;
+	      }
+	    do
+	      {
+		moves.push_back(this->_best_moves.front());
+		contin = this->make_move(
+					 this->_best_moves.front());
+		//this->print_board();
+	      } while (contin && !this->_best_moves.empty());
+	  } while (contin);
+      }
 
     for (std::vector<move>::const_iterator pos = moves.begin();
 	 pos != moves.end(); ++pos)
@@ -470,8 +550,7 @@ namespace checkers
     (void)args;
 
     nio << "  Analyzing ...\n";
-    absearch::think(this->_best_moves, this->_board,
-		    this->_depth_limit, this->_time_limit, true);
+    this->think(true);
   }
 
   void engine::do_print(const std::vector<std::string>& args)
@@ -542,8 +621,40 @@ namespace checkers
       "    analyze         Engine thinks about what move it make next"
       " if it were on\n"
       "                    move.\n"
+      "    bench [D] [N]   Search the benchmark positions to depth D"
+      " with N\n"
+      "                    processes, and show the nodes, time and"
+      " speed.\n"
+      "    bench eval [N]  Evaluate the benchmark positions N times,"
+      " and show the\n"
+      "                    speed.\n"
+      "    bench batch [N] Evaluate the benchmark positions N times"
+      " in a batch, and\n"
+      "                    show the speed.\n"
+      "    bench nnue [N]  Evaluate the benchmark positions N times"
+      " by the linear\n"
+      "                    evaluation and the neural network, and"
+      " show the speed.\n"
+      "    bench read FILE Read the positions of the dataset FILE, and"
+      " show the\n"
+      "                    speed.\n"
       "    black           Set Black on move, and the engine will"
       " play White.\n"
+      "    book FILE       Play the moves of the opening book of FILE,"
+      " or \"off\".\n"
+      "    divide D [HASH] Perft to depth D for each move, with HASH"
+      " megabytes of\n"
+      "                    hash table.\n"
+      "    egdb FILE [MB]  Probe the endgame databases of FILE in the"
+      " search, with a\n"
+      "                    cache of MB megabytes (16 by default, 1024 at"
+      " most), or\n"
+      "                    \"off\".\n"
+      "    engine TYPE     Search with TYPE \"alphabeta\" (default) or"
+      " \"mcts\".\n"
+      "    evalcache MB    Cache leaf evaluations in MB megabytes"
+      " (0 by default,\n"
+      "                    off).\n"
       "    force           Set the engine to play neither color"
       " (\"force mode\").\n"
       "    go              Leave force mode and set the engine to"
@@ -554,6 +665,21 @@ namespace checkers
       "    history         Show the record of moves.\n"
       "    new             Reset the board to the standard starting"
       " position.\n"
+      "    nnue FILE       Evaluate with the neural network in FILE,"
+      " \"default\" for\n"
+      "                    the network counting the material, or"
+      " \"off\".\n"
+      "    nnue save FILE  Write the neural network to FILE.\n"
+      "    pattern FILE    Evaluate with the pattern tables in FILE,"
+      " \"default\" for\n"
+      "                    the tables equal to the linear evaluation,"
+      " or \"off\".\n"
+      "    pattern save FILE\n"
+      "                    Write the pattern tables to FILE.\n"
+      "    perft D [HASH]  Count the positions D moves away, with HASH"
+      " megabytes of\n"
+      "                    hash table (0 by default), and show the"
+      " speed.\n"
       "    ping N          N is a decimal number.  Reply by sending"
       " the string\n"
       "                    \"pong N\"\n"
@@ -562,12 +688,25 @@ namespace checkers
       "    rotate          Rotate the board 180 degrees.\n"
       "    setboard FEN    Set up the pieces position on the"
       " board.\n"
+      "    setoption NAME VALUE\n"
+      "                    Set the evaluation weight NAME to VALUE.\n"
       "    sd DEPTH        The engine should limit its thinking to"
-      " DEPTH ply.\n"
+      " DEPTH ply\n"
+      "                    (alphabeta only, mcts has no depth).\n"
       "    st TIME         Set the time control to TIME seconds per"
       " move.\n"
+      "    threads N       Search with N threads (mcts and perft"
+      " only).\n"
+      "    stats [raw]     Show the statistics of the last search,"
+      " raw as\n"
+      "                    \"name value\" lines.\n"
       "    undo            Back up a move.\n"
       "    verbose         Toggle verbose mode.\n"
+      "    weights [FILE]  Show the evaluation weights, read them"
+      " from FILE, or\n"
+      "                    \"default\" for the built-in weights.\n"
+      "    weights save FILE\n"
+      "                    Write the evaluation weights to FILE.\n"
       "    white           Set White on move, and the engine will"
       " play Black.\n";
     // --+----1----+----2----+----3----+----4----+----5----+----6--|
@@ -597,6 +736,116 @@ namespace checkers
     this->print_board();
   }
 
+  void engine::do_perft(const std::vector<std::string>& args)
+  {
+    if (args.size() <= 1)
+      {
+	nio << "Error (option missing): perft\n";
+	return;
+      }
+
+    // to_int() reads a negative depth as unlimited, which would
+    // never end.
+    const int depth = this->to_int(args[1]);
+
+    if (UNLIMITED == depth)
+      {
+	nio << "Error (bad depth): " << args[1] << '\n';
+	return;
+      }
+
+    perft::set_hash_size(args.size() > 2 ?
+			 std::max(0, this->to_int(args[2])) : 0);
+    struct timeval time = timeval::now();
+    const uint64_t nodes = perft::count(this->_board, depth,
+					this->_threads);
+    time = timeval::now() - time;
+    perft::set_hash_size(0);
+
+    nio << perft::report(nodes, time);
+  }
+
+  void engine::do_nnue(const std::vector<std::string>& args)
+  {
+    if (args.size() <= 1 || ("save" == args[1] && args.size() <= 2))
+      {
+	nio << "Error (option missing): nnue\n";
+	return;
+      }
+
+    try
+      {
+	if ("save" == args[1])
+	  {
+	    nnue::save(args[2]);
+	    return;
+	  }
+	if ("off" == args[1])
+	  {
+	    nnue::disable();
+	  }
+	else
+	  {
+	    if ("default" == args[1])
+	      {
+		nnue::reset();
+	      }
+	    else
+	      {
+		nnue::load(args[1]);
+	      }
+	    nnue::enable();
+	    pattern::disable();
+	  }
+      }
+    catch (const std::runtime_error& e)
+      {
+	nio << e.what() << '\n';
+	return;
+      }
+    // The values in the hash table and evaluation cache are stale.
+    absearch::clear_hash();
+  }
+
+  void engine::do_pattern(const std::vector<std::string>& args)
+  {
+    if (args.size() <= 1 || ("save" == args[1] && args.size() <= 2))
+      {
+	nio << "Error (option missing): pattern\n";
+	return;
+      }
+
+    try
+      {
+	if ("save" == args[1])
+	  {
+	    pattern::save(args[2]);
+	    return;
+	  }
+	if ("off" == args[1])
+	  {
+	    pattern::disable();
+	  }
+	else if ("default" == args[1])
+	  {
+	    pattern::reset();
+	    nnue::disable();
+	  }
+	else
+	  {
+	    pattern::load(args[1]);
+	    nnue::disable();
+	  }
+      }
+    catch (const std::runtime_error& e)
+      {
+	nio << e.what() << '\n';
+	return;
+      }
+    // The values in the hash table and evaluation cache are stale.
+    absearch::clear_hash();
+  }
+
   void engine::do_quit(const std::vector<std::string>& args)
   {
     // Void the warning: unused parameter ‘args’
@@ -605,6 +854,174 @@ namespace checkers
     exit(0);
   }
 
+  void engine::do_divide(const std::vector<std::string>& args)
+  {
+    if (args.size() <= 1)
+      {
+	nio << "Error (option missing): divide\n";
+	return;
+      }
+
+    // to_int() reads a negative depth as unlimited, which would
+    // never end.
+    const int depth = this->to_int(args[1]);
+
+    if (UNLIMITED == depth)
+      {
+	nio << "Error (bad depth): " << args[1] << '\n';
+	return;
+      }
+
+    perft::set_hash_size(args.size() > 2 ?
+			 std::max(0, this->to_int(args[2])) : 0);
+    nio << perft::divide(this->_board, depth, this->_threads);
+    perft::set_hash_size(0);
+  }
+
+  void engine::do_book(const std::vector<std::string>& args)
+  {
+    if (args.size() <= 1)
+      {
+	nio << "Error (option missing): book\n";
+	return;
+      }
+
+    try
+      {
+	if ("off" == args[1])
+	  {
+	    book::close();
+	  }
+	else
+	  {
+	    book::open(args[1]);
+	  }
+      }
+    catch (const std::runtime_error& e)
+      {
+	nio << e.what() << '\n';
+      }
+  }
+
+  void engine::do_egdb(const std::vector<std::string>& args)
+  {
+    if (args.size() <= 1)
+      {
+	nio << "Error (option missing): egdb\n";
+	return;
+      }
+
+    try
+      {
+	if ("off" == args[1])
+	  {
+	    egdb::close();
+	  }
+	else
+	  {
+	    unsigned int megabytes = egdb::cache_size;
+
+	    if (args.size() > 2)
+	      {
+		megabytes = std::max(1, this->to_int(args[2]));
+	      }
+	    egdb::open(args[1], megabytes);
+	  }
+      }
+    catch (const std::runtime_error& e)
+      {
+	nio << e.what() << '\n';
+	return;
+      }
+    // The values in the hash table are stale.
+    absearch::clear_hash();
+  }
+
+  void engine::do_engine(const std::vector<std::string>& args)
+  {
+    if (args.size() <= 1)
+      {
+	nio << "Error (option missing): engine\n";
+	return;
+      }
+
+    if ("alphabeta" == args[1])
+      {
+	this->_search = ALPHA_BETA;
+      }
+    else if ("mcts" == args[1])
+      {
+	this->_search = MONTE_CARLO;
+      }
+    else
+      {
+	nio << "Error (unknown engine type): " << args[1] << '\n';
+	return;
+      }
+    this->_best_moves.clear();
+  }
+
+  void engine::do_bench(const std::vector<std::string>& args)
+  {
+    unsigned int depth = bench::DEFAULT_DEPTH;
+    unsigned int workers = 1;
+
+    if (args.size() > 1 && "eval" == args[1])
+      {
+	nio << bench::evaluation(args.size() > 2 ?
+				 std::max(1, this->to_int(args[2])) :
+				 bench::DEFAULT_ROUNDS);
+	return;
+      }
+    if (args.size() > 1 && "batch" == args[1])
+      {
+	nio << bench::batch(args.size() > 2 ?
+			    std::max(1, this->to_int(args[2])) :
+			    bench::DEFAULT_ROUNDS);
+	return;
+      }
+    if (args.size() > 1 && "nnue" == args[1])
+      {
+	nio << bench::network(args.size() > 2 ?
+			      std::max(1, this->to_int(args[2])) :
+			      bench::DEFAULT_ROUNDS);
+	return;
+      }
+    if (args.size() > 1)
+      {
+	depth = std::max(1, this->to_int(args[1]));
+      }
+    if (args.size() > 2)
+      {
+	workers = std::max(1, this->to_int(args[2]));
+      }
+
+    try
+      {
+	if (args.size() > 2 && "read" == args[1])
+	  {
+	    nio << bench::reader(args[2]);
+	    return;
+	  }
+	nio << bench::search(depth, workers);
+      }
+    catch (const std::runtime_error& e)
+      {
+	nio << e.what() << '\n';
+      }
+    this->_best_moves.clear();
+  }
+
+  void engine::do_evalcache(const std::vector<std::string>& args)
+  {
+    if (args.size() <= 1)
+      {
+	nio << "Error (option missing): evalcache\n";
+	return;
+      }
+    absearch::set_eval_cache_size(std::max(0, this->to_int(args[1])));
+  }
+
   void engine::do_force(const std::vector<std::string>& args)
   {
     // Void the warning: unused parameter ‘args’
@@ -633,6 +1050,28 @@ namespace checkers
     this->_time_limit  = this->to_int(args[1]);
   }
 
+  void engine::do_threads(const std::vector<std::string>& args)
+  {
+    if (args.size() <= 1)
+      {
+	nio << "Error (option missing): threads\n";
+	return;
+      }
+    this->_threads = std::max(1, this->to_int(args[1]));
+  }
+
+  void engine::do_stats(const std::vector<std::string>& args)
+  {
+    if (args.size() > 1 && "raw" == args[1])
+      {
+	nio << stats::report_raw();
+      }
+    else
+      {
+	nio << stats::report();
+      }
+  }
+
   void engine::do_setboard(const std::vector<std::string>& args)
   {
     if (args.size() <= 1)
@@ -657,6 +1096,60 @@ namespace checkers
     nio << io::flush;
   }
 
+  void engine::do_setoption(const std::vector<std::string>& args)
+  {
+    if (args.size() <= 2)
+      {
+	nio << "Error (option missing): setoption\n";
+	return;
+      }
+    if (!evaluate::set_weight(args[1], this->to_int(args[2])))
+      {
+	nio << "Error (unknown option): " << args[1] << '\n';
+	return;
+      }
+    // The values in the hash table and evaluation cache are stale.
+    absearch::clear_hash();
+  }
+
+  void engine::do_weights(const std::vector<std::string>& args)
+  {
+    if (args.size() <= 1)
+      {
+	nio << evaluate::report_weights();
+	return;
+      }
+    if ("save" == args[1] && args.size() <= 2)
+      {
+	nio << "Error (option missing): weights\n";
+	return;
+      }
+
+    try
+      {
+	if ("save" == args[1])
+	  {
+	    evaluate::save_weights(args[2]);
+	    return;
+	  }
+	if ("default" == args[1])
+	  {
+	    evaluate::reset_weights();
+	  }
+	else
+	  {
+	    evaluate::load_weights(args[1]);
+	  }
+      }
+    catch (const std::runtime_error& e)
+      {
+	nio << e.what() << '\n';
+	return;
+      }
+    // The values in the hash table and evaluation cache are stale.
+    absearch::clear_hash();
+  }
+
   void engine::do_undo(const std::vector<std::string>& args)
   {
     // Void the warning: unused parameter ‘args’
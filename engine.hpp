@@ -42,6 +42,14 @@ namespace checkers
 
 
   private:
+    enum search
+      {
+	/// Alpha-beta pruning, see absearch.
+	ALPHA_BETA,
+	/// Monte-Carlo tree search, see mcts.
+	MONTE_CARLO
+      };
+
     engine(void);
     /// Define but not implement, to prevent object copy.
     engine(const engine& rhs);
@@ -59,6 +67,7 @@ namespace checkers
 
     bool make_move(const move& move);
 
+    void think(bool verbose);
     void computer_makes_move(void);
     bool human_makes_move(const std::string& str);
 
@@ -69,21 +78,34 @@ namespace checkers
     bool result(void);
 
     void do_analyze(const std::vector<std::string>& args);
+    void do_bench(const std::vector<std::string>& args);
     void do_black(const std::vector<std::string>& args);
+    void do_book(const std::vector<std::string>& args);
+    void do_divide(const std::vector<std::string>& args);
+    void do_egdb(const std::vector<std::string>& args);
+    void do_engine(const std::vector<std::string>& args);
+    void do_evalcache(const std::vector<std::string>& args);
     void do_force(const std::vector<std::string>& args);
     void do_go(const std::vector<std::string>& args);
     void do_help(const std::vector<std::string>& args);
     void do_history(const std::vector<std::string>& args);
     void do_new(const std::vector<std::string>& args);
+    void do_nnue(const std::vector<std::string>& args);
+    void do_pattern(const std::vector<std::string>& args);
+    void do_perft(const std::vector<std::string>& args);
     void do_ping(const std::vector<std::string>& args);
     void do_print(const std::vector<std::string>& args);
     void do_quit(const std::vector<std::string>& args);
     void do_rotate(const std::vector<std::string>& args);
     void do_sd(const std::vector<std::string>& args);
     void do_st(const std::vector<std::string>& args);
+    void do_stats(const std::vector<std::string>& args);
+    void do_setoption(const std::vector<std::string>& args);
     void do_setboard(const std::vector<std::string>& args);
     void do_undo(const std::vector<std::string>& args);
+    void do_threads(const std::vector<std::string>& args);
     void do_verbose(const std::vector<std::string>& args);
+    void do_weights(const std::vector<std::string>& args);
     void do_white(const std::vector<std::string>& args);
     void not_implemented(const std::vector<std::string>& args);
 
@@ -94,6 +116,8 @@ namespace checkers
     int _depth_limit;
     int _time_limit;
     bool _verbose;
+    search _search;
+    int _threads;
 
     static const int UNLIMITED = 999999;
 
@@ -24,21 +24,432 @@
  *  @brief Artificial intelligence, weight of evaluate strategy.
  */
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
 #include "evaluate.hpp"
+#include "nnue.hpp"
+#include "pattern.hpp"
 
 namespace checkers
 {
+	namespace
+	{
+		/// A weight by name.
+		struct weight
+		{
+			const char* name;
+			int evaluate::weights::* member;
+		};
+
+		/// The names of the weights, in the order of the struct.
+		const weight WEIGHTS[] =
+		{
+			{ "man", &evaluate::weights::man },
+			{ "king", &evaluate::weights::king },
+			{ "mover", &evaluate::weights::mover },
+			{ "kings_row", &evaluate::weights::kings_row },
+			{ "edge", &evaluate::weights::edge }
+		};
+		const unsigned int WEIGHTS_SIZE =
+			sizeof(WEIGHTS) / sizeof(WEIGHTS[0]);
+
+		/// Set the weight @e name of @e weights to @e value.
+		bool set(evaluate::weights& weights, const std::string& name,
+			int value)
+		{
+			for (unsigned int i = 0; i < WEIGHTS_SIZE; ++i)
+			{
+				if (name == WEIGHTS[i].name)
+				{
+					weights.*WEIGHTS[i].member = value;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/** @brief The linear value for Black of a position, from
+		 *   scratch.
+		 */
+		inline int linear_black(bitboard black, bitboard white,
+			bitboard kings)
+		{
+			const bitboard unoccupied = ~(black | white);
+			const bitboard up = (unoccupied << 4) |
+				((unoccupied & bitboard::MASK_L3) << 3) |
+				((unoccupied & bitboard::MASK_L5) << 5);
+			const bitboard down = (unoccupied >> 4) |
+				((unoccupied & bitboard::MASK_R3) >> 3) |
+				((unoccupied & bitboard::MASK_R5) >> 5);
+
+			return (int((black & ~kings).count()) -
+				int((white & ~kings).count())) *
+					evaluate::_weights.man +
+				(int((black & kings).count()) -
+				 int((white & kings).count())) *
+					evaluate::_weights.king +
+				(int(((down | (up & kings)) & black).count()) -
+				 int(((up | (down & kings)) & white).count())) *
+					evaluate::_weights.mover +
+				(int((black & bitboard::WHITE_KINGS_ROW).count()) -
+				 int((white & bitboard::BLACK_KINGS_ROW).count())) *
+					evaluate::_weights.kings_row +
+				(int((black & bitboard::EDGES).count()) -
+				 int((white & bitboard::EDGES).count())) *
+					evaluate::_weights.edge;
+		}
+
+#if defined(__AVX2__)
+		/// Count the set bits of each 32-bit lane.
+		inline __m256i count(__m256i x)
+		{
+			const __m256i table = _mm256_setr_epi8(
+				0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+				0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+			const __m256i nibble = _mm256_set1_epi8(0x0f);
+			const __m256i bytes = _mm256_add_epi8(
+				_mm256_shuffle_epi8(table,
+					_mm256_and_si256(x, nibble)),
+				_mm256_shuffle_epi8(table, _mm256_and_si256(
+					_mm256_srli_epi32(x, 4), nibble)));
+
+			// Sum the 4 bytes of each lane.
+			return _mm256_madd_epi16(_mm256_maddubs_epi16(bytes,
+				_mm256_set1_epi8(1)), _mm256_set1_epi16(1));
+		}
+
+		/// The weighted difference of the counts of @e x and @e y.
+		inline __m256i term(__m256i x, __m256i y, int weight)
+		{
+			return _mm256_mullo_epi32(_mm256_sub_epi32(count(x),
+				count(y)), _mm256_set1_epi32(weight));
+		}
+
+		/// The linear values for Black of 8 positions, from scratch.
+		inline __m256i linear_black(__m256i black, __m256i white,
+			__m256i kings)
+		{
+			const __m256i unoccupied = _mm256_xor_si256(
+				_mm256_or_si256(black, white),
+				_mm256_set1_epi32(-1));
+			const __m256i l3 = _mm256_set1_epi32(bitboard::MASK_L3);
+			const __m256i l5 = _mm256_set1_epi32(bitboard::MASK_L5);
+			const __m256i r3 = _mm256_set1_epi32(bitboard::MASK_R3);
+			const __m256i r5 = _mm256_set1_epi32(bitboard::MASK_R5);
+			const __m256i up = _mm256_or_si256(
+				_mm256_slli_epi32(unoccupied, 4), _mm256_or_si256(
+				_mm256_slli_epi32(_mm256_and_si256(unoccupied, l3),
+				3), _mm256_slli_epi32(_mm256_and_si256(unoccupied,
+				l5), 5)));
+			const __m256i down = _mm256_or_si256(
+				_mm256_srli_epi32(unoccupied, 4), _mm256_or_si256(
+				_mm256_srli_epi32(_mm256_and_si256(unoccupied, r3),
+				3), _mm256_srli_epi32(_mm256_and_si256(unoccupied,
+				r5), 5)));
+			const __m256i edges = _mm256_set1_epi32(bitboard::EDGES);
+
+			__m256i val = term(_mm256_andnot_si256(kings, black),
+				_mm256_andnot_si256(kings, white),
+				evaluate::_weights.man);
+			val = _mm256_add_epi32(val, term(
+				_mm256_and_si256(black, kings),
+				_mm256_and_si256(white, kings),
+				evaluate::_weights.king));
+			val = _mm256_add_epi32(val, term(
+				_mm256_and_si256(black, _mm256_or_si256(down,
+					_mm256_and_si256(up, kings))),
+				_mm256_and_si256(white, _mm256_or_si256(up,
+					_mm256_and_si256(down, kings))),
+				evaluate::_weights.mover));
+			val = _mm256_add_epi32(val, term(
+				_mm256_and_si256(black, _mm256_set1_epi32(
+					bitboard::WHITE_KINGS_ROW)),
+				_mm256_and_si256(white, _mm256_set1_epi32(
+					bitboard::BLACK_KINGS_ROW)),
+				evaluate::_weights.kings_row));
+			return _mm256_add_epi32(val, term(
+				_mm256_and_si256(black, edges),
+				_mm256_and_si256(white, edges),
+				evaluate::_weights.edge));
+		}
+#endif
+	}
+
 	/**
 	 *  @retval >0 when the current player is ahead in game
 	 *  @retval <0 when the current player is behind in game
 	 */
 	int evaluate::evaluate(const board& board)
 	{
-		return men(board) * evaluate::WEIGHT_MAN +
-			kings(board) * evaluate::WEIGHT_KING +
-			movers(board) * evaluate::WEIGHT_MOVER +
-			kings_row(board) * evaluate::WEIGHT_KINGS_ROW +
-			edges(board) * evaluate::WEIGHT_EDGE;
+		if (nnue::is_enabled())
+		{
+			return nnue::evaluate(board);
+		}
+		if (pattern::is_enabled())
+		{
+			return pattern::evaluate(board);
+		}
+		return linear(board);
+	}
+
+	int evaluate::evaluate(const board& board, unsigned int ply)
+	{
+		if (nnue::is_enabled())
+		{
+			return nnue::evaluate(board, ply);
+		}
+		return evaluate::evaluate(board);
+	}
+
+	/**  The sum of the weighted terms, the counts kept by the board
+	 *   and the movers.
+	 */
+	int evaluate::linear(const board& board)
+	{
+		const int val = material(board) +
+			movers(board) * evaluate::_weights.mover;
+
+		assert(evaluate_full(board) == val);
+		return val;
+	}
+
+	/**  The first stage counts the terms kept by the board.  The
+	 *   movers are only computed when the value may fall inside the
+	 *   window.
+	 *  @param exact Set false when the value returned is only on the
+	 *   same side of the window as the real value, which is at most
+	 *   lazy_margin() away.
+	 *  @param ply The ply of the search, for the network.
+	 */
+	int evaluate::lazy(const board& board, int alpha, int beta,
+		bool& exact, unsigned int ply)
+	{
+		if (nnue::is_enabled() || pattern::is_enabled())
+		{
+			exact = true;
+			return evaluate::evaluate(board, ply);
+		}
+
+		const int val = material(board);
+
+		// Written so that an infinite window does not overflow.
+		if (val + evaluate::lazy_margin() <= alpha ||
+			val - evaluate::lazy_margin() >= beta)
+		{
+			exact = false;
+			return val;
+		}
+		exact = true;
+		return linear(board);
+	}
+
+	/**  The terms kept up to date by the board, all but the movers.
+	 */
+	int evaluate::material(const board& board)
+	{
+		const board::player player = board.is_black_to_move() ?
+			board::BLACK : board::WHITE;
+		const board::player opponent = board.is_black_to_move() ?
+			board::WHITE : board::BLACK;
+
+		return (int(board.get_feature(player, board::MEN)) -
+			 int(board.get_feature(opponent, board::MEN))) *
+				evaluate::_weights.man +
+			(int(board.get_feature(player, board::KINGS)) -
+			 int(board.get_feature(opponent, board::KINGS))) *
+				evaluate::_weights.king +
+			(int(board.get_feature(player, board::HOME_ROW)) -
+			 int(board.get_feature(opponent, board::HOME_ROW))) *
+				evaluate::_weights.kings_row +
+			(int(board.get_feature(player, board::EDGE)) -
+			 int(board.get_feature(opponent, board::EDGE))) *
+				evaluate::_weights.edge;
+	}
+
+	/**  The terms are counted from the pieces on the board, instead of
+	 *   the counts kept by the board.
+	 */
+	int evaluate::evaluate_full(const board& board)
+	{
+		return men(board) * evaluate::_weights.man +
+			kings(board) * evaluate::_weights.king +
+			movers(board) * evaluate::_weights.mover +
+			kings_row(board) * evaluate::_weights.kings_row +
+			edges(board) * evaluate::_weights.edge;
+	}
+
+	/**  The positions are gathered 8 at a time into arrays of each
+	 *   bitboard.
+	 */
+	void evaluate::evaluate_batch(const board* boards, size_t size,
+		int* values)
+	{
+		uint32_t black[8] __attribute__((aligned(32)));
+		uint32_t white[8] __attribute__((aligned(32)));
+		uint32_t kings[8] __attribute__((aligned(32)));
+		int32_t players[8] __attribute__((aligned(32)));
+
+		for (size_t i = 0; i < size; i += 8)
+		{
+			const size_t n = std::min(size - i, size_t(8));
+
+			for (size_t j = 0; j < n; ++j)
+			{
+				black[j] = boards[i + j].get_black_pieces().bits();
+				white[j] = boards[i + j].get_white_pieces().bits();
+				kings[j] = boards[i + j].get_kings().bits();
+				players[j] = boards[i + j].is_black_to_move() ?
+					board::BLACK : board::WHITE;
+			}
+			evaluate_batch(black, white, kings, players, n,
+				values + i);
+		}
+	}
+
+	/**  With AVX2, 8 positions are evaluated in the lanes of each
+	 *   instruction, and the rest one by one.
+	 *  @param players board::BLACK or board::WHITE, the player to
+	 *   move.
+	 */
+	void evaluate::evaluate_batch(const uint32_t* black,
+		const uint32_t* white, const uint32_t* kings,
+		const int32_t* players, size_t size, int* values)
+	{
+		size_t i = 0;
+
+#if defined(__AVX2__)
+		for (; i + 8 <= size; i += 8)
+		{
+			const __m256i val = linear_black(
+				_mm256_loadu_si256(
+				reinterpret_cast<const __m256i*>(black + i)),
+				_mm256_loadu_si256(
+				reinterpret_cast<const __m256i*>(white + i)),
+				_mm256_loadu_si256(
+				reinterpret_cast<const __m256i*>(kings + i)));
+
+			// The players are +1 or -1.
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(values + i),
+				_mm256_sign_epi32(val, _mm256_loadu_si256(
+				reinterpret_cast<const __m256i*>(players + i))));
+		}
+#endif
+		for (; i < size; ++i)
+		{
+			values[i] = players[i] * linear_black(bitboard(black[i]),
+				bitboard(white[i]), bitboard(kings[i]));
+		}
+	}
+
+	/**  The reference of evaluate_batch(), one position at a time by
+	 *   evaluate_full().
+	 */
+	void evaluate::evaluate_batch_scalar(const board* boards,
+		size_t size, int* values)
+	{
+		for (size_t i = 0; i < size; ++i)
+		{
+			values[i] = evaluate_full(boards[i]);
+		}
+	}
+
+	/**  The weights take effect at the next evaluation.  Values
+	 *   cached or stored in the hash table are not cleared here.
+	 *  @return false when there is no weight named @e name.
+	 */
+	bool evaluate::set_weight(const std::string& name, int value)
+	{
+		return set(evaluate::_weights, name, value);
+	}
+
+	void evaluate::reset_weights(void)
+	{
+		const weights weights =
+		{
+			WEIGHT_MAN, WEIGHT_KING, WEIGHT_MOVER, WEIGHT_KINGS_ROW,
+			WEIGHT_EDGE
+		};
+
+		evaluate::_weights = weights;
+	}
+
+	/**  The file has a line "name value" for each weight to change,
+	 *   the same as report_weights().  Empty lines and lines beginning
+	 *   with '#' are skipped.  The weights in use are kept when the
+	 *   file is bad.
+	 */
+	void evaluate::load_weights(const std::string& filename)
+	{
+		std::ifstream file(filename.c_str());
+		weights weights = evaluate::_weights;
+		std::string line;
+		unsigned int number = 0;
+
+		if (!file)
+		{
+			/// @throw std::runtime_error when the file cannot be
+			///  opened.
+			throw std::runtime_error(
+				"Error (cannot open weights file): " + filename);
+		}
+		while (std::getline(file, line))
+		{
+			std::istringstream stream(line);
+			std::string name;
+			int value;
+
+			++number;
+			if (!(stream >> name) || '#' == name[0])
+			{
+				continue;
+			}
+			if (!(stream >> value) || !set(weights, name, value))
+			{
+				std::ostringstream error;
+
+				error << "Error (bad weight at line " << number <<
+					"): " << filename;
+				/// @throw std::runtime_error when a line is not
+				///  a known name and a number.
+				throw std::runtime_error(error.str());
+			}
+		}
+
+		evaluate::_weights = weights;
+	}
+
+	void evaluate::save_weights(const std::string& filename)
+	{
+		std::ofstream file(filename.c_str(),
+			std::ios::out | std::ios::trunc);
+
+		file << report_weights();
+		file.close();
+		if (!file)
+		{
+			/// @throw std::runtime_error when the file cannot be
+			///  written.
+			throw std::runtime_error(
+				"Error (cannot write weights file): " + filename);
+		}
+	}
+
+	std::string evaluate::report_weights(void)
+	{
+		std::ostringstream stream;
+
+		for (unsigned int i = 0; i < WEIGHTS_SIZE; ++i)
+		{
+			stream << WEIGHTS[i].name << ' ' <<
+				evaluate::_weights.*WEIGHTS[i].member << '\n';
+		}
+		return stream.str();
 	}
 
 	int evaluate::men(const board& board)
@@ -89,6 +500,13 @@ namespace checkers
 			((board.get_white_pieces() & bitboard::EDGES).count() -
 			 (board.get_black_pieces() & bitboard::EDGES).count());
 	}
+
+	evaluate::weights evaluate::_weights =
+	{
+		evaluate::WEIGHT_MAN, evaluate::WEIGHT_KING,
+		evaluate::WEIGHT_MOVER, evaluate::WEIGHT_KINGS_ROW,
+		evaluate::WEIGHT_EDGE
+	};
 }
 
 // End of file
@@ -27,6 +27,12 @@
 #ifndef __EVALUATE_HPP__
 #define __EVALUATE_HPP__
 
+extern "C"
+{
+	#include <stddef.h>
+	#include <stdint.h>
+}
+#include <string>
 #include "board.hpp"
 
 namespace checkers
@@ -34,17 +40,82 @@ namespace checkers
 	/// Weight of evaluate strategy.
 	namespace evaluate
 	{
+		/// Default weights.
 		const int WEIGHT_MAN       = 256;
 		const int WEIGHT_KING      = WEIGHT_MAN * 2;
 		const int WEIGHT_MOVER     = 2;
 		const int WEIGHT_KINGS_ROW = 16;
 		const int WEIGHT_EDGE      = 8;
 
+		/** @brief The weights of the linear evaluation, next to each
+		 *   other in one cache line.
+		 */
+		struct weights
+		{
+			int man;
+			int king;
+			int mover;
+			int kings_row;
+			int edge;
+		};
+
+		/// The weights in use, changed by the functions below only.
+		extern weights _weights;
+
+		/// Get the weights in use.
+		inline const weights& get_weights(void);
+		/// Set the weight named @e name to @e value.
+		bool set_weight(const std::string& name, int value);
+		/// Set the default weights.
+		void reset_weights(void);
+		/// Read the weights from @e filename.
+		void load_weights(const std::string& filename);
+		/// Write the weights to @e filename.
+		void save_weights(const std::string& filename);
+		/// Show the weights as lines of names and values.
+		std::string report_weights(void);
+
+		/** @brief The largest mobility term, 12 movers against none,
+		 *   so a lazy evaluation never lands on the wrong side of the
+		 *   window.
+		 */
+		inline int lazy_margin(void);
+
 		inline int win(void);
 		inline int infinity(void);
 		inline int unknown(void);
 
+		/// Evaluate by the network, the pattern tables or linear().
 		int evaluate(const board& board);
+		/** @brief The same as evaluate(), for a board @e ply moves
+		 *   into a search, whose network accumulators are kept.
+		 */
+		int evaluate(const board& board, unsigned int ply);
+		/// Evaluate by the weighted terms.
+		int linear(const board& board);
+		/** @brief Evaluate by the weighted terms, but skip the movers
+		 *   when the value is far outside (@e alpha, @e beta).
+		 */
+		int lazy(const board& board, int alpha, int beta, bool& exact,
+			unsigned int ply);
+		/// The weighted terms without the movers.
+		int material(const board& board);
+		/// Evaluate from scratch, to check the incremental counts.
+		int evaluate_full(const board& board);
+		/** @brief Evaluate @e size independent @e boards into
+		 *   @e values by the weighted terms, from scratch.
+		 */
+		void evaluate_batch(const board* boards, size_t size,
+			int* values);
+		/** @brief Evaluate @e size positions given as arrays of
+		 *   bitboards and players to move into @e values.
+		 */
+		void evaluate_batch(const uint32_t* black, const uint32_t* white,
+			const uint32_t* kings, const int32_t* players, size_t size,
+			int* values);
+		/// The same as evaluate_batch(), one position at a time.
+		void evaluate_batch_scalar(const board* boards, size_t size,
+			int* values);
 		int men(const board& board);
 		int kings(const board& board);
 		int movers(const board& board);
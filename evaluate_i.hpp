@@ -27,10 +27,23 @@
 #ifndef __EVALUATE_I_HPP__
 #define __EVALUATE_I_HPP__
 
+#include <cstdlib>
 #include <limits>
 
 namespace checkers
 {
+	inline const evaluate::weights& evaluate::get_weights(void)
+	{
+		return evaluate::_weights;
+	}
+
+	inline int evaluate::lazy_margin(void)
+	{
+		return 12 * std::abs(evaluate::_weights.mover);
+	}
+
+	/**  The value of a win does not change with the weights.
+	 */
 	inline int evaluate::win(void)
 	{
 		return evaluate::WEIGHT_MAN * 256;
@@ -0,0 +1,512 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file mcts.cpp
+ *  @brief Artificial intelligence, Monte-Carlo tree search.
+ */
+
+extern "C"
+{
+	#include <pthread.h>
+	#include <unistd.h>
+}
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include "evaluate.hpp"
+#include "mcts.hpp"
+#include "nonstdio.hpp"
+
+namespace checkers
+{
+	namespace
+	{
+		/// The exploration constant of UCT.
+		const double EXPLORATION = 1.4;
+
+		inline bitboard up_4(const bitboard& x)
+		{
+			return x << 4;
+		}
+
+		inline bitboard up_35(const bitboard& x)
+		{
+			return ((x & bitboard::MASK_L3) << 3) |
+				((x & bitboard::MASK_L5) << 5);
+		}
+
+		inline bitboard down_4(const bitboard& x)
+		{
+			return x >> 4;
+		}
+
+		inline bitboard down_35(const bitboard& x)
+		{
+			return ((x & bitboard::MASK_R3) >> 3) |
+				((x & bitboard::MASK_R5) >> 5);
+		}
+	}
+
+	/**  The search runs until the time is up, or a command is waiting.
+	 *   There is no depth limit.
+	 *  @return Timeout or not.
+	 */
+	bool mcts::think(std::vector<move>& best_moves, const board& board,
+		time_t second, unsigned int threads, bool verbose)
+	{
+		if (mcts::_tree.size() != mcts::tree_size)
+		{
+			mcts::_tree.resize(mcts::tree_size);
+		}
+		mcts::_tree[0] = node();
+		mcts::_size = 1;
+		mcts::_playouts = 0;
+		mcts::_stop = false;
+		mcts::_full = false;
+		mcts::_root = board;
+		mcts::_deadline = timeval::now() + second;
+
+		if (threads > mcts::max_threads)
+		{
+			threads = mcts::max_threads;
+		}
+		else if (0 == threads)
+		{
+			threads = 1;
+		}
+		pthread_t tids[mcts::max_threads];
+		uint32_t seeds[mcts::max_threads];
+		unsigned int i;
+		int err;
+
+		struct timeval start = timeval::now();
+		for (i = 0; i < threads; ++i)
+		{
+			seeds[i] = 0x9e3779b9U * (i + 1);
+			if ((err = pthread_create(&tids[i], NULL, &mcts::worker,
+				&seeds[i])) != 0)
+			{
+				mcts::_stop = true;
+				while (i--)
+				{
+					pthread_join(tids[i], NULL);
+				}
+				/// @throw std::runtime_error when
+				///  pthread_create() failed.
+				throw std::runtime_error(
+					std::string("pthread_create() failed: ")
+					+ std::strerror(err));
+			}
+		}
+		// Like absearch, stop on a command waiting, which this thread
+		// alone reads, nio is not for the workers.
+		while (!mcts::_stop)
+		{
+			usleep(10000);
+			nio << io::flush;
+			if (nio.lines_to_read() || nio.eof())
+			{
+				mcts::_stop = true;
+			}
+		}
+		for (i = 0; i < threads; ++i)
+		{
+			pthread_join(tids[i], NULL);
+		}
+		struct timeval end = timeval::now();
+
+		// The principal variation follows the most visited children.
+		best_moves.clear();
+		int n = 0;
+		while (2 == mcts::_tree[n]._state)
+		{
+			int best = -1;
+			for (int c = mcts::_tree[n]._first_child; c <
+				mcts::_tree[n]._first_child +
+				mcts::_tree[n]._children; ++c)
+			{
+				if (mcts::_tree[c]._visits > 0 && (best < 0 ||
+					mcts::_tree[c]._visits >
+					mcts::_tree[best]._visits))
+				{
+					best = c;
+				}
+			}
+			if (best < 0)
+			{
+				break;
+			}
+			best_moves.push_back(mcts::_tree[best]._move);
+			n = best;
+		}
+
+		if (verbose)
+		{
+			nio << mcts::thinking_detail(end - start, best_moves);
+		}
+
+		/** @retval true while timeout.
+		 *  @retval false while the tree pool is exhausted.
+		 */
+		return !mcts::_full;
+	}
+
+	// ================================================================
+
+	void* mcts::worker(void* arg)
+	{
+		random rng(*static_cast<uint32_t*>(arg));
+		std::vector<int> path;
+		path.reserve(64);
+
+		for (unsigned int i = 1; !mcts::_stop; ++i)
+		{
+			mcts::playout(rng, path);
+			__sync_fetch_and_add(&mcts::_playouts, 1);
+
+			if (0 == i % 64 && mcts::is_timeout())
+			{
+				mcts::_stop = true;
+			}
+		}
+
+		return NULL;
+	}
+
+	/**  Select a line down to a leaf, expand it, play a random game out
+	 *   of it and back the result up along the line.
+	 */
+	void mcts::playout(random& rng, std::vector<int>& path)
+	{
+		board board(mcts::_root);
+		bitboard jumper(bitboard::EMPTY);
+		int n = 0;
+
+		path.clear();
+		path.push_back(n);
+		for (;;)
+		{
+			if (0 == mcts::_tree[n]._state && (0 == n ||
+				mcts::_tree[n]._visits >= mcts::expand_visits))
+			{
+				mcts::expand(n, board, jumper);
+			}
+			if (2 != mcts::_tree[n]._state ||
+				0 == mcts::_tree[n]._children)
+			{
+				break;
+			}
+			__sync_synchronize();
+
+			int c = mcts::select(n);
+			__sync_fetch_and_add(&mcts::_tree[c]._virtual_loss, 1);
+			path.push_back(c);
+
+			jumper = board.make_move(mcts::_tree[c]._move) ?
+				mcts::_tree[c]._move.get_dest() :
+				bitboard(bitboard::EMPTY);
+			n = c;
+		}
+
+		mcts::backup(path, mcts::simulate(board, jumper, rng));
+	}
+
+	/** @return The child with the highest upper confidence bound.  The
+	 *   playouts in flight count as lost, which is the virtual loss.
+	 */
+	int mcts::select(int parent)
+	{
+		const node& p = mcts::_tree[parent];
+		const int first = p._first_child;
+		const int last = first + p._children;
+		const double log_n = std::log(double(p._visits + 1));
+		double best_val = -1.0;
+		int best = first;
+
+		for (int c = first; c < last; ++c)
+		{
+			const node& child = mcts::_tree[c];
+			const int n = child._visits + child._virtual_loss;
+			if (0 == n)
+			{
+				return c;
+			}
+
+			const double val = child._score / (2.0 * n) +
+				EXPLORATION * std::sqrt(log_n / n);
+			if (val > best_val)
+			{
+				best_val = val;
+				best = c;
+			}
+		}
+		return best;
+	}
+
+	/**  Only one worker wins the race to expand a leaf, the others play
+	 *   out of the leaf meanwhile.
+	 *  @param jumper The piece has to jump once more, if any.
+	 */
+	void mcts::expand(int parent, const board& board, bitboard jumper)
+	{
+		if (mcts::_full || !__sync_bool_compare_and_swap(
+			&mcts::_tree[parent]._state, 0, 1))
+		{
+			return;
+		}
+
+		std::vector<move> moves = board.generate_moves();
+		if (jumper)
+		{
+			// Continue a multiple jump by the same piece only.
+			std::vector<move>::iterator pos = moves.begin();
+			while (pos != moves.end())
+			{
+				pos = (pos->get_src() == jumper) ?
+					pos + 1 : moves.erase(pos);
+			}
+		}
+
+		const int children = moves.size();
+		const int first = __sync_fetch_and_add(&mcts::_size, children);
+		if (first + children > int(mcts::tree_size))
+		{
+			mcts::_full = true;
+			mcts::_tree[parent]._state = 0;
+			return;
+		}
+
+		for (int i = 0; i < children; ++i)
+		{
+			node& child = mcts::_tree[first + i];
+			child = node();
+			child._move = moves[i];
+			child._black = board.is_black_to_move();
+		}
+
+		mcts::_tree[parent]._first_child = first;
+		mcts::_tree[parent]._children = children;
+		__sync_synchronize();
+		mcts::_tree[parent]._state = 2;
+	}
+
+	/** @return The result in half points for black.
+	 */
+	int mcts::simulate(board board, bitboard jumper, random& rng)
+	{
+		for (unsigned int i = 0; i < mcts::playout_limit; ++i)
+		{
+			if (!mcts::random_move(board, jumper, rng))
+			{
+				// The player on move has no legal move.
+				return board.is_black_to_move() ? 0 : 2;
+			}
+		}
+
+		return mcts::result(board);
+	}
+
+	/**  The random policy picks a piece which may move, then one of its
+	 *   moves, without generating the moves of the whole board.
+	 *  @return false when the player on move has no legal move.
+	 */
+	bool mcts::random_move(board& board, bitboard& jumper, random& rng)
+	{
+		const bool black = board.is_black_to_move();
+		bitboard pieces = jumper;
+		bool jump = true;
+
+		if (!pieces)
+		{
+			pieces = black ? board.get_black_jumpers() :
+				board.get_white_jumpers();
+		}
+		if (!pieces)
+		{
+			jump = false;
+			pieces = black ? board.get_black_movers() :
+				board.get_white_movers();
+			if (!pieces)
+			{
+				return false;
+			}
+		}
+
+		for (unsigned int k = rng.next() % pieces.count(); k; --k)
+		{
+			pieces &= ~pieces.lsb();
+		}
+		const bitboard src = pieces.lsb();
+		const bool is_king = src & board.get_kings();
+		const bitboard unoccupied = board.get_unoccupied();
+		const bitboard enemy = black ? board.get_white_pieces() :
+			board.get_black_pieces();
+
+		bitboard step[4];
+		bitboard over[4];
+		unsigned int dirs = 0;
+		if (black || is_king)
+		{
+			step[dirs] = up_4(src);
+			over[dirs++] = up_35(up_4(src));
+			step[dirs] = up_35(src);
+			over[dirs++] = up_4(up_35(src));
+		}
+		if (!black || is_king)
+		{
+			step[dirs] = down_4(src);
+			over[dirs++] = down_35(down_4(src));
+			step[dirs] = down_35(src);
+			over[dirs++] = down_4(down_35(src));
+		}
+
+		bitboard dest[4];
+		bitboard capture[4];
+		unsigned int n = 0;
+		for (unsigned int i = 0; i < dirs; ++i)
+		{
+			if (jump)
+			{
+				if ((step[i] & enemy) && (over[i] & unoccupied))
+				{
+					capture[n] = step[i];
+					dest[n++] = over[i];
+				}
+			}
+			else if (step[i] & unoccupied)
+			{
+				capture[n] = bitboard(bitboard::EMPTY);
+				dest[n++] = step[i];
+			}
+		}
+		assert(n > 0);
+
+		const unsigned int i = rng.next() % n;
+		const move move(src, dest[i], capture[i],
+			capture[i] & board.get_kings(), !is_king && (dest[i] &
+			(black ? bitboard::BLACK_KINGS_ROW :
+			 bitboard::WHITE_KINGS_ROW)));
+		jumper = board.make_move(move) ? dest[i] :
+			bitboard(bitboard::EMPTY);
+
+		/// @retval true when a move is made.
+		return true;
+	}
+
+	void mcts::backup(const std::vector<int>& path, int result)
+	{
+		__sync_fetch_and_add(&mcts::_tree[path[0]]._visits, 1);
+		for (std::vector<int>::size_type i = 1; i < path.size(); ++i)
+		{
+			node& n = mcts::_tree[path[i]];
+			__sync_fetch_and_add(&n._score,
+				n._black ? result : 2 - result);
+			__sync_fetch_and_add(&n._visits, 1);
+			__sync_fetch_and_sub(&n._virtual_loss, 1);
+		}
+	}
+
+	/**  Adjudicate a playout which reaches the length limit.  A player
+	 *   ahead by a man or more is taken as the winner.
+	 *  @return The result in half points for black.
+	 */
+	int mcts::result(const board& board)
+	{
+		int val = evaluate::evaluate(board);
+		if (board.is_white_to_move())
+		{
+			val = -val;
+		}
+
+		return val >= evaluate::get_weights().man ? 2 :
+			(val <= -evaluate::get_weights().man ? 0 : 1);
+	}
+
+	// ================================================================
+
+	std::string mcts::thinking_detail(struct timeval time,
+		const std::vector<move>& best_moves)
+	{
+		std::ostringstream stream;
+		const double seconds = time.tv_sec + time.tv_usec / 1e6;
+		int visits = 0;
+		int score = 0;
+
+		if (2 == mcts::_tree[0]._state && !best_moves.empty())
+		{
+			for (int c = mcts::_tree[0]._first_child; c <
+				mcts::_tree[0]._first_child +
+				mcts::_tree[0]._children; ++c)
+			{
+				if (mcts::_tree[c]._move == best_moves.front())
+				{
+					visits = mcts::_tree[c]._visits;
+					score = mcts::_tree[c]._score;
+				}
+			}
+		}
+
+		stream <<
+			"  playouts    nodes      time   per sec   win%\n"
+			"  ------------------------------------------"
+				"----------------------------------\n";
+		stream << "  " << std::setw(8) << mcts::_playouts;
+		stream << ' ' << std::setw(8) << std::min(int(mcts::_size),
+			int(mcts::tree_size));
+		stream << ' ' << std::setw(5) << time.tv_sec << '.' <<
+			std::setw(3) << std::setfill('0') <<
+			(time.tv_usec / 1000) << std::setfill(' ');
+		stream << ' ' << std::setw(9) << (seconds > 0 ?
+			long(mcts::_playouts / seconds) : 0L);
+		stream << ' ' << std::setw(6) << std::setprecision(1) <<
+			std::fixed << (visits ? 50.0 * score / visits : 0.0);
+
+		// Print out the moves.
+		for (std::vector<move>::size_type i = 0;
+			i < best_moves.size(); ++i)
+		{
+			if (i > 0 && 0 == i % 6)
+			{
+				stream << "\n"
+					"                                       "
+					"         ";
+			}
+			stream << ' ' << best_moves[i];
+		}
+		stream << '\n';
+
+		return stream.str();
+	}
+
+	std::vector<mcts::node> mcts::_tree;
+	volatile int mcts::_size = 0;
+	volatile int mcts::_playouts = 0;
+	volatile bool mcts::_stop = false;
+	volatile bool mcts::_full = false;
+	struct timeval mcts::_deadline = { 0, 0 };
+	board mcts::_root;
+}
+
+// End of file
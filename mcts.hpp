@@ -0,0 +1,130 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file mcts.hpp
+ *  @brief Artificial intelligence, Monte-Carlo tree search.
+ */
+
+#ifndef __MCTS_HPP__
+#define __MCTS_HPP__
+
+extern "C"
+{
+	#include <stdint.h>
+}
+#include "board.hpp"
+#include "timeval.hpp"
+
+namespace checkers
+{
+	/** @class mcts
+	 *  @brief Monte-Carlo tree search (UCT) with parallel playouts.
+	 *
+	 *   The tree lives in a preallocated node pool shared by all the
+	 *   worker threads.  Nodes are allocated, expanded and updated with
+	 *   atomic operations only, and a virtual loss spreads concurrent
+	 *   workers over different lines of play.
+	 */
+	class mcts
+	{
+	public:
+		static bool think(std::vector<move>& best_moves,
+			const board& board, time_t second,
+			unsigned int threads = 1, bool verbose = false);
+
+		/// Number of nodes in the tree pool.
+		static const unsigned int tree_size = 1024 * 1024;
+		/// Maximum number of worker threads.
+		static const unsigned int max_threads = 64;
+		/// Maximum length of a random playout in plies.
+		static const unsigned int playout_limit = 160;
+		/// Playouts through a leaf before it is expanded.
+		static const int expand_visits = 2;
+
+	private:
+		struct node
+		{
+			inline node(void);
+
+			/// The move leads to this node.
+			move _move;
+			/// Whether the move is made by the player has dark
+			/// pieces.
+			bool _black;
+			/// 0 for a leaf, 1 while expanding, 2 when expanded.
+			volatile int _state;
+			/// Index of the first child in the pool.
+			volatile int _first_child;
+			/// Number of children.
+			volatile int _children;
+			/// Number of playouts through this node.
+			volatile int _visits;
+			/// Results in half points for the player made the move.
+			volatile int _score;
+			/// Playouts in flight through this node.
+			volatile int _virtual_loss;
+		};
+
+		/// Private random number generator of a worker.
+		class random
+		{
+		public:
+			explicit inline random(uint32_t seed);
+			inline uint32_t next(void);
+
+		private:
+			uint32_t _state;
+		};
+
+		static void* worker(void* arg);
+		static void playout(random& rng, std::vector<int>& path);
+
+		static int select(int parent);
+		static void expand(int parent, const board& board,
+			bitboard jumper);
+		static int simulate(board board, bitboard jumper,
+			random& rng);
+		static bool random_move(board& board, bitboard& jumper,
+			random& rng);
+		static void backup(const std::vector<int>& path, int result);
+
+		inline static bool is_timeout(void);
+
+		/// Result of a playout, in half points for black.
+		static int result(const board& board);
+
+		static std::string thinking_detail(struct timeval time,
+			const std::vector<move>& best_moves);
+
+		static std::vector<node> _tree;
+		static volatile int _size;
+		static volatile int _playouts;
+		static volatile bool _stop;
+		static volatile bool _full;
+		static struct timeval _deadline;
+		static board _root;
+	};
+}
+
+#include "mcts_i.hpp"
+#endif // __MCTS_HPP__
+// End of file
@@ -0,0 +1,66 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file mcts_i.hpp
+ *  @brief Artificial intelligence, Monte-Carlo tree search.
+ */
+
+#ifndef __MCTS_I_HPP__
+#define __MCTS_I_HPP__
+
+namespace checkers
+{
+	/**  A placeholder move, replaced when the node is expanded.
+	 */
+	inline mcts::node::node(void) :
+		_move(bitboard(0x1U), bitboard(0x1U << 4),
+			bitboard(bitboard::EMPTY), false, false),
+		_black(false), _state(0), _first_child(0), _children(0),
+		_visits(0), _score(0), _virtual_loss(0)
+	{
+	}
+
+	inline mcts::random::random(uint32_t seed) :
+		_state(seed ? seed : 0x9e3779b9U)
+	{
+	}
+
+	/** @return The next number of a xorshift sequence.
+	 */
+	inline uint32_t mcts::random::next(void)
+	{
+		this->_state ^= this->_state << 13;
+		this->_state ^= this->_state >> 17;
+		this->_state ^= this->_state << 5;
+		return this->_state;
+	}
+
+	// ================================================================
+
+	inline bool mcts::is_timeout(void)
+	{
+		return timeval::now() > mcts::_deadline;
+	}
+}
+
+#endif // __MCTS_I_HPP__
+// End of file
@@ -0,0 +1,597 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file nnue.cpp
+ *  @brief Artificial intelligence, efficiently updatable neural network.
+ */
+
+#if defined(__AVX2__) || defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include "board.hpp"
+#include "nnue.hpp"
+
+namespace checkers
+{
+	namespace
+	{
+		/// Tag at the beginning of a file of weights.
+		const char MAGIC[4] = { 'N', 'N', 'U', 'E' };
+
+		/// Value of a man of the material network, 256 a man.
+		const int16_t MAN = 4;
+		/// Value of a king of the material network, 512 a king.
+		const int16_t KING = 8;
+		/// Scale of the material network from the hidden layer.
+		const int8_t SCALE = 64;
+	}
+
+	/**  Safe to call from many threads, as nothing is kept.
+	 */
+	int nnue::evaluate(const board& board)
+	{
+		int16_t accumulator[nnue::hidden] __attribute__((aligned(32)));
+
+		nnue::build(accumulator, board.get_black_pieces(),
+			board.get_white_pieces(), board.get_kings());
+		return nnue::forward(board, accumulator);
+	}
+
+	/**  The leaves of a search are mostly siblings, a move or two
+	 *   apart, so the accumulator of a ply is updated from the last
+	 *   position evaluated at that ply, or from the one at the
+	 *   previous ply when that is closer.  It is built from scratch
+	 *   when updating takes more inputs than the pieces on the board.
+	 */
+	int nnue::evaluate(const board& board, unsigned int ply)
+	{
+		const unsigned int i = std::min(ply, nnue::max_ply - 1);
+		frame& frame = nnue::_stack[i];
+		bitboard planes[4];
+
+		nnue::split(board, planes);
+
+		unsigned int distance = nnue::distance(frame, planes);
+
+		if (i > 0 && nnue::distance(nnue::_stack[i - 1], planes) <
+			distance)
+		{
+			frame = nnue::_stack[i - 1];
+			distance = nnue::distance(frame, planes);
+		}
+		if (distance > board.get_occupied().count())
+		{
+			nnue::build(frame._accumulator, board.get_black_pieces(),
+				board.get_white_pieces(), board.get_kings());
+			std::copy(planes, planes + 4, frame._planes);
+			frame._generation = nnue::_generation;
+		}
+		else
+		{
+			nnue::update(frame, planes);
+		}
+
+#ifndef NDEBUG
+		int16_t built[nnue::hidden];
+
+		nnue::build(built, board.get_black_pieces(),
+			board.get_white_pieces(), board.get_kings());
+		assert(0 == std::memcmp(built, frame._accumulator,
+			sizeof(built)));
+#endif
+		return nnue::forward(board, frame._accumulator);
+	}
+
+	/**  The reference for the vector kernels, which builds the
+	 *   accumulator from scratch too.
+	 */
+	int nnue::evaluate_scalar(const board& board)
+	{
+		int16_t accumulator[nnue::hidden];
+		uint8_t in[nnue::hidden];
+		uint8_t out[nnue::hidden];
+		int val = nnue::_output_bias;
+
+		nnue::build(accumulator, board.get_black_pieces(),
+			board.get_white_pieces(), board.get_kings());
+		for (unsigned int i = 0; i < nnue::hidden; ++i)
+		{
+			in[i] = uint8_t(std::min(std::max(int(accumulator[i]), 0),
+				127));
+		}
+		for (unsigned int i = 0; i < nnue::hidden; ++i)
+		{
+			int sum = nnue::_hidden_biases[i];
+
+			for (unsigned int j = 0; j < nnue::hidden; ++j)
+			{
+				sum += int(in[j]) * nnue::_hidden_weights[i][j];
+			}
+			out[i] = uint8_t(std::min(std::max(sum >>
+				nnue::hidden_shift, 0), 127));
+		}
+		for (unsigned int i = 0; i < nnue::hidden; ++i)
+		{
+			val += int(out[i]) * nnue::_output_weights[i];
+		}
+		return board.is_black_to_move() ? val : -val;
+	}
+
+	/**  The accumulators of the search are rebuilt at the first use,
+	 *   as they are not kept up to date while the network is disabled.
+	 */
+	void nnue::enable(void)
+	{
+		nnue::_enabled = true;
+		++nnue::_generation;
+	}
+
+	void nnue::disable(void)
+	{
+		nnue::_enabled = false;
+		++nnue::_generation;
+	}
+
+	/**  The first two values of the accumulator count the material of
+	 *   Black and of White, and pass through the hidden layer
+	 *   unchanged.  The output is their difference, scaled to the
+	 *   weights of evaluate::evaluate().
+	 */
+	void nnue::reset(void)
+	{
+		std::memset(nnue::_input_weights, 0, sizeof(nnue::_input_weights));
+		std::memset(nnue::_input_biases, 0, sizeof(nnue::_input_biases));
+		std::memset(nnue::_hidden_weights, 0,
+			sizeof(nnue::_hidden_weights));
+		std::memset(nnue::_hidden_biases, 0,
+			sizeof(nnue::_hidden_biases));
+		std::memset(nnue::_output_weights, 0,
+			sizeof(nnue::_output_weights));
+		nnue::_output_bias = 0;
+
+		for (unsigned int i = 0; i < 32; ++i)
+		{
+			nnue::_input_weights[i][0] = MAN;
+			nnue::_input_weights[32 + i][0] = KING;
+			nnue::_input_weights[64 + i][1] = MAN;
+			nnue::_input_weights[96 + i][1] = KING;
+		}
+		nnue::_hidden_weights[0][0] = 0x1 << nnue::hidden_shift;
+		nnue::_hidden_weights[1][1] = 0x1 << nnue::hidden_shift;
+		nnue::_output_weights[0] = SCALE;
+		nnue::_output_weights[1] = -SCALE;
+		++nnue::_generation;
+	}
+
+	/**  The file is the tag "NNUE", then the version, the number of
+	 *   inputs and the size of the hidden layer as 32-bit integers,
+	 *   then the weights and biases of the layers in the order they
+	 *   are declared.  Integers are in the byte order of the host.
+	 *
+	 *   The weights in use are kept when the file is bad.
+	 */
+	void nnue::load(const std::string& filename)
+	{
+		std::ifstream file(filename.c_str(),
+			std::ios::in | std::ios::binary);
+		char magic[sizeof(MAGIC)];
+		uint32_t header[3];
+		int16_t input_weights[nnue::inputs][nnue::hidden];
+		int16_t input_biases[nnue::hidden];
+		int8_t hidden_weights[nnue::hidden][nnue::hidden];
+		int32_t hidden_biases[nnue::hidden];
+		int8_t output_weights[nnue::hidden];
+		int32_t output_bias;
+
+		if (!file)
+		{
+			/// @throw std::runtime_error when the file cannot be
+			///  opened.
+			throw std::runtime_error(
+				"Error (cannot open network file): " + filename);
+		}
+		file.read(magic, sizeof(magic));
+		file.read(reinterpret_cast<char*>(header), sizeof(header));
+		if (!file || 0 != std::memcmp(magic, MAGIC, sizeof(MAGIC)) ||
+			nnue::version != header[0] ||
+			nnue::inputs != header[1] || nnue::hidden != header[2])
+		{
+			/// @throw std::runtime_error when the header is wrong.
+			throw std::runtime_error(
+				"Error (bad network file header): " + filename);
+		}
+		file.read(reinterpret_cast<char*>(input_weights),
+			sizeof(input_weights));
+		file.read(reinterpret_cast<char*>(input_biases),
+			sizeof(input_biases));
+		file.read(reinterpret_cast<char*>(hidden_weights),
+			sizeof(hidden_weights));
+		file.read(reinterpret_cast<char*>(hidden_biases),
+			sizeof(hidden_biases));
+		file.read(reinterpret_cast<char*>(output_weights),
+			sizeof(output_weights));
+		file.read(reinterpret_cast<char*>(&output_bias),
+			sizeof(output_bias));
+		if (!file || EOF != file.peek())
+		{
+			/// @throw std::runtime_error when the file is too short
+			///  or too long.
+			throw std::runtime_error(
+				"Error (bad network file size): " + filename);
+		}
+
+		std::memcpy(nnue::_input_weights, input_weights,
+			sizeof(input_weights));
+		std::memcpy(nnue::_input_biases, input_biases,
+			sizeof(input_biases));
+		std::memcpy(nnue::_hidden_weights, hidden_weights,
+			sizeof(hidden_weights));
+		std::memcpy(nnue::_hidden_biases, hidden_biases,
+			sizeof(hidden_biases));
+		std::memcpy(nnue::_output_weights, output_weights,
+			sizeof(output_weights));
+		nnue::_output_bias = output_bias;
+		++nnue::_generation;
+	}
+
+	void nnue::save(const std::string& filename)
+	{
+		std::ofstream file(filename.c_str(),
+			std::ios::out | std::ios::binary | std::ios::trunc);
+		const uint32_t header[3] =
+		{
+			nnue::version, nnue::inputs, nnue::hidden
+		};
+
+		file.write(MAGIC, sizeof(MAGIC));
+		file.write(reinterpret_cast<const char*>(header),
+			sizeof(header));
+		file.write(reinterpret_cast<const char*>(nnue::_input_weights),
+			sizeof(nnue::_input_weights));
+		file.write(reinterpret_cast<const char*>(nnue::_input_biases),
+			sizeof(nnue::_input_biases));
+		file.write(reinterpret_cast<const char*>(nnue::_hidden_weights),
+			sizeof(nnue::_hidden_weights));
+		file.write(reinterpret_cast<const char*>(nnue::_hidden_biases),
+			sizeof(nnue::_hidden_biases));
+		file.write(reinterpret_cast<const char*>(nnue::_output_weights),
+			sizeof(nnue::_output_weights));
+		file.write(reinterpret_cast<const char*>(&nnue::_output_bias),
+			sizeof(nnue::_output_bias));
+		file.close();
+		if (!file)
+		{
+			/// @throw std::runtime_error when the file cannot be
+			///  written.
+			throw std::runtime_error(
+				"Error (cannot write network file): " + filename);
+		}
+	}
+
+	void nnue::split(const board& board, bitboard* planes)
+	{
+		const bitboard kings = board.get_kings();
+
+		planes[0] = board.get_black_pieces() & ~kings;
+		planes[1] = board.get_black_pieces() & kings;
+		planes[2] = board.get_white_pieces() & ~kings;
+		planes[3] = board.get_white_pieces() & kings;
+	}
+
+	unsigned int nnue::distance(const frame& frame,
+		const bitboard* planes)
+	{
+		unsigned int distance = 0;
+
+		if (nnue::_generation != frame._generation)
+		{
+			return ~0U;
+		}
+		for (unsigned int i = 0; i < 4; ++i)
+		{
+			distance += (frame._planes[i] ^ planes[i]).count();
+		}
+		return distance;
+	}
+
+	/**  The input of a piece on @e square of plane @e i is
+	 *   i * 32 + @e square, as by feature().
+	 */
+	void nnue::update(frame& frame, const bitboard* planes)
+	{
+		for (unsigned int i = 0; i < 4; ++i)
+		{
+			for (bitboard pieces = frame._planes[i] & ~planes[i];
+				pieces; )
+			{
+				const bitboard piece = pieces.lsb();
+
+				pieces ^= piece;
+				nnue::remove(frame._accumulator, i * 32 + piece.ntz());
+			}
+			for (bitboard pieces = planes[i] & ~frame._planes[i];
+				pieces; )
+			{
+				const bitboard piece = pieces.lsb();
+
+				pieces ^= piece;
+				nnue::add(frame._accumulator, i * 32 + piece.ntz());
+			}
+			frame._planes[i] = planes[i];
+		}
+	}
+
+	int nnue::forward(const board& board, const int16_t* accumulator)
+	{
+		uint8_t in[nnue::hidden] __attribute__((aligned(32)));
+		uint8_t out[nnue::hidden] __attribute__((aligned(32)));
+
+		nnue::clip(accumulator, in);
+		nnue::propagate(in, out);
+
+		const int val = nnue::output(out);
+
+		assert(nnue::evaluate_scalar(board) ==
+			(board.is_black_to_move() ? val : -val));
+		return board.is_black_to_move() ? val : -val;
+	}
+
+	void nnue::build(int16_t* accumulator, bitboard black,
+		bitboard white, bitboard kings)
+	{
+		std::memcpy(accumulator, nnue::_input_biases,
+			sizeof(nnue::_input_biases));
+		for (bitboard pieces = black | white; pieces; )
+		{
+			const bitboard piece = pieces.lsb();
+
+			pieces ^= piece;
+			nnue::add(accumulator, nnue::feature(
+				(piece & black) ? 0 : 1, piece & kings, piece));
+		}
+	}
+
+#if defined(__AVX2__)
+	void nnue::clip(const int16_t* accumulator, uint8_t* out)
+	{
+		const __m256i max = _mm256_set1_epi16(127);
+		const __m256i low = _mm256_min_epi16(max, _mm256_loadu_si256(
+			reinterpret_cast<const __m256i*>(accumulator)));
+		const __m256i high = _mm256_min_epi16(max, _mm256_loadu_si256(
+			reinterpret_cast<const __m256i*>(accumulator + 16)));
+
+		// The packing works within 128-bit lanes.
+		_mm256_store_si256(reinterpret_cast<__m256i*>(out),
+			_mm256_permute4x64_epi64(_mm256_packus_epi16(low, high),
+				0xd8));
+	}
+
+	/**  The products of 8-bit inputs and weights are summed in pairs
+	 *   into 16 bits, which do not overflow with inputs up to 127, and
+	 *   then into 32 bits.  Eight rows are reduced together by
+	 *   horizontal additions.
+	 */
+	void nnue::propagate(const uint8_t* in, uint8_t* out)
+	{
+		const __m256i ones = _mm256_set1_epi16(1);
+		const __m256i input = _mm256_load_si256(
+			reinterpret_cast<const __m256i*>(in));
+		__m256i sums[nnue::hidden / 8];
+
+		for (unsigned int i = 0; i < nnue::hidden; i += 8)
+		{
+			__m256i rows[8];
+
+			for (unsigned int j = 0; j < 8; ++j)
+			{
+				rows[j] = _mm256_madd_epi16(_mm256_maddubs_epi16(
+					input, _mm256_load_si256(
+					reinterpret_cast<const __m256i*>(
+					nnue::_hidden_weights[i + j]))), ones);
+			}
+
+			const __m256i low = _mm256_hadd_epi32(
+				_mm256_hadd_epi32(rows[0], rows[1]),
+				_mm256_hadd_epi32(rows[2], rows[3]));
+			const __m256i high = _mm256_hadd_epi32(
+				_mm256_hadd_epi32(rows[4], rows[5]),
+				_mm256_hadd_epi32(rows[6], rows[7]));
+
+			sums[i / 8] = _mm256_srai_epi32(_mm256_add_epi32(
+				_mm256_load_si256(reinterpret_cast<const __m256i*>(
+				nnue::_hidden_biases + i)), _mm256_add_epi32(
+				_mm256_permute2x128_si256(low, high, 0x20),
+				_mm256_permute2x128_si256(low, high, 0x31))),
+				nnue::hidden_shift);
+		}
+
+		const __m256i max = _mm256_set1_epi16(127);
+		const __m256i packed = _mm256_packus_epi16(
+			_mm256_min_epi16(max, _mm256_packs_epi32(sums[0], sums[1])),
+			_mm256_min_epi16(max, _mm256_packs_epi32(sums[2], sums[3])));
+
+		// The packing works within 128-bit lanes.
+		_mm256_store_si256(reinterpret_cast<__m256i*>(out),
+			_mm256_permutevar8x32_epi32(packed,
+				_mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7)));
+	}
+
+	int nnue::output(const uint8_t* in)
+	{
+		const __m256i sum = _mm256_madd_epi16(_mm256_maddubs_epi16(
+			_mm256_load_si256(reinterpret_cast<const __m256i*>(in)),
+			_mm256_load_si256(reinterpret_cast<const __m256i*>(
+			nnue::_output_weights))), _mm256_set1_epi16(1));
+		__m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum),
+			_mm256_extracti128_si256(sum, 1));
+
+		half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4e));
+		half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xb1));
+		return nnue::_output_bias + _mm_cvtsi128_si32(half);
+	}
+#elif defined(__SSSE3__)
+	void nnue::clip(const int16_t* accumulator, uint8_t* out)
+	{
+		const __m128i max = _mm_set1_epi16(127);
+
+		for (unsigned int i = 0; i < nnue::hidden; i += 16)
+		{
+			_mm_store_si128(reinterpret_cast<__m128i*>(out + i),
+				_mm_packus_epi16(
+				_mm_min_epi16(max, _mm_loadu_si128(
+				reinterpret_cast<const __m128i*>(accumulator + i))),
+				_mm_min_epi16(max, _mm_loadu_si128(
+				reinterpret_cast<const __m128i*>(accumulator + i +
+				8)))));
+		}
+	}
+
+	/**  The products of 8-bit inputs and weights are summed in pairs
+	 *   into 16 bits, which do not overflow with inputs up to 127, and
+	 *   then into 32 bits.  Four rows are reduced together by
+	 *   horizontal additions.
+	 */
+	void nnue::propagate(const uint8_t* in, uint8_t* out)
+	{
+		const __m128i ones = _mm_set1_epi16(1);
+		const __m128i low = _mm_load_si128(
+			reinterpret_cast<const __m128i*>(in));
+		const __m128i high = _mm_load_si128(
+			reinterpret_cast<const __m128i*>(in + 16));
+		__m128i sums[nnue::hidden / 4];
+
+		for (unsigned int i = 0; i < nnue::hidden; i += 4)
+		{
+			__m128i rows[4];
+
+			for (unsigned int j = 0; j < 4; ++j)
+			{
+				const __m128i* weights =
+					reinterpret_cast<const __m128i*>(
+					nnue::_hidden_weights[i + j]);
+
+				rows[j] = _mm_add_epi32(
+					_mm_madd_epi16(_mm_maddubs_epi16(low,
+					_mm_load_si128(weights)), ones),
+					_mm_madd_epi16(_mm_maddubs_epi16(high,
+					_mm_load_si128(weights + 1)), ones));
+			}
+			sums[i / 4] = _mm_srai_epi32(_mm_add_epi32(
+				_mm_load_si128(reinterpret_cast<const __m128i*>(
+				nnue::_hidden_biases + i)), _mm_hadd_epi32(
+				_mm_hadd_epi32(rows[0], rows[1]),
+				_mm_hadd_epi32(rows[2], rows[3]))),
+				nnue::hidden_shift);
+		}
+
+		const __m128i max = _mm_set1_epi16(127);
+
+		for (unsigned int i = 0; i < nnue::hidden / 4; i += 4)
+		{
+			_mm_store_si128(reinterpret_cast<__m128i*>(out + i * 4),
+				_mm_packus_epi16(
+				_mm_min_epi16(max,
+				_mm_packs_epi32(sums[i], sums[i + 1])),
+				_mm_min_epi16(max,
+				_mm_packs_epi32(sums[i + 2], sums[i + 3]))));
+		}
+	}
+
+	int nnue::output(const uint8_t* in)
+	{
+		const __m128i ones = _mm_set1_epi16(1);
+		const __m128i* weights =
+			reinterpret_cast<const __m128i*>(nnue::_output_weights);
+		__m128i sum = _mm_add_epi32(
+			_mm_madd_epi16(_mm_maddubs_epi16(_mm_load_si128(
+			reinterpret_cast<const __m128i*>(in)),
+			_mm_load_si128(weights)), ones),
+			_mm_madd_epi16(_mm_maddubs_epi16(_mm_load_si128(
+			reinterpret_cast<const __m128i*>(in + 16)),
+			_mm_load_si128(weights + 1)), ones));
+
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4e));
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xb1));
+		return nnue::_output_bias + _mm_cvtsi128_si32(sum);
+	}
+#else
+	void nnue::clip(const int16_t* accumulator, uint8_t* out)
+	{
+		for (unsigned int i = 0; i < nnue::hidden; ++i)
+		{
+			out[i] = uint8_t(std::min(std::max(int(accumulator[i]), 0),
+				127));
+		}
+	}
+
+	void nnue::propagate(const uint8_t* in, uint8_t* out)
+	{
+		for (unsigned int i = 0; i < nnue::hidden; ++i)
+		{
+			int sum = nnue::_hidden_biases[i];
+
+			for (unsigned int j = 0; j < nnue::hidden; ++j)
+			{
+				sum += int(in[j]) * nnue::_hidden_weights[i][j];
+			}
+			out[i] = uint8_t(std::min(std::max(sum >>
+				nnue::hidden_shift, 0), 127));
+		}
+	}
+
+	int nnue::output(const uint8_t* in)
+	{
+		int val = nnue::_output_bias;
+
+		for (unsigned int i = 0; i < nnue::hidden; ++i)
+		{
+			val += int(in[i]) * nnue::_output_weights[i];
+		}
+		return val;
+	}
+#endif
+
+	bool nnue::initialize(void)
+	{
+		nnue::reset();
+		return true;
+	}
+
+	bool nnue::_enabled = false;
+	unsigned int nnue::_generation = 1;
+	int16_t nnue::_input_weights[nnue::inputs][nnue::hidden];
+	int16_t nnue::_input_biases[nnue::hidden];
+	int8_t nnue::_hidden_weights[nnue::hidden][nnue::hidden];
+	int32_t nnue::_hidden_biases[nnue::hidden];
+	int8_t nnue::_output_weights[nnue::hidden];
+	int32_t nnue::_output_bias = 0;
+	nnue::frame nnue::_stack[nnue::max_ply];
+	const bool nnue::_initialized = nnue::initialize();
+}
+
+// End of file
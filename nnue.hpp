@@ -0,0 +1,180 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file nnue.hpp
+ *  @brief Artificial intelligence, efficiently updatable neural network.
+ */
+
+#ifndef __NNUE_HPP__
+#define __NNUE_HPP__
+
+extern "C"
+{
+	#include <stdint.h>
+}
+#include <string>
+#include "bitboard.hpp"
+
+namespace checkers
+{
+	class board;
+
+	/** @class nnue
+	 *  @brief Evaluate a board by a small neural network, whose first
+	 *   layer is updated incrementally by the moves.
+	 *
+	 *   The 128 inputs are the pieces on squares, 32 squares each for
+	 *   black men, black kings, white men and white kings.  The first
+	 *   layer sums the 16-bit weights of the pieces on the board into
+	 *   an accumulator of 32 values, which a search keeps per ply and
+	 *   updates from the pieces that differ from the last position
+	 *   evaluated at the same or the previous ply.  The board knows
+	 *   nothing of the network.  The accumulator clipped to 0..127
+	 *   feeds a
+	 *   32x32 layer of 8-bit weights, whose sums are shifted right by
+	 *   6 and clipped to 0..127 again, and then a single output with
+	 *   8-bit weights.  The output is the value for Black.  The
+	 *   weights at start count the material like evaluate::linear().
+	 *
+	 *   The two dense layers use AVX2 or SSSE3 when the compiler
+	 *   targets them, and plain C++ otherwise.  All the kernels give
+	 *   the same results.
+	 */
+	class nnue
+	{
+	public:
+		/** @brief Value of @e board for the player to move, from an
+		 *   accumulator built from scratch.
+		 */
+		static int evaluate(const board& board);
+		/** @brief The same as evaluate(), from the accumulator kept
+		 *   for @e ply of the search.  Not thread-safe.
+		 */
+		static int evaluate(const board& board, unsigned int ply);
+		/// The same as evaluate(), by plain C++ only.
+		static int evaluate_scalar(const board& board);
+
+		/// Whether evaluate::evaluate() uses the network.
+		inline static bool is_enabled(void);
+		/// Evaluate by the network.
+		static void enable(void);
+		/// Evaluate without the network again.
+		static void disable(void);
+		/** @brief Set the weights to count the material only, the
+		 *   weights at start.
+		 */
+		static void reset(void);
+		/// Read the weights from @e filename.
+		static void load(const std::string& filename);
+		/// Write the weights to @e filename.
+		static void save(const std::string& filename);
+
+		/** @brief The weights the accumulators are for.  It changes
+		 *   with the weights, to tell the stale accumulators.
+		 */
+		inline static unsigned int generation(void);
+		/// The input of a piece of @e color 0 for Black, 1 for White.
+		inline static unsigned int feature(unsigned int color,
+			bool is_king, bitboard square);
+		/// Sum the weights of the pieces into @e accumulator.
+		static void build(int16_t* accumulator, bitboard black,
+			bitboard white, bitboard kings);
+		/// Add the input @e feature to @e accumulator.
+		inline static void add(int16_t* accumulator,
+			unsigned int feature);
+		/// Remove the input @e feature from @e accumulator.
+		inline static void remove(int16_t* accumulator,
+			unsigned int feature);
+		/// Move a piece from the input @e from to the input @e to.
+		inline static void replace(int16_t* accumulator,
+			unsigned int from,
+			unsigned int to);
+
+		/// Number of inputs.
+		static const unsigned int inputs = 128;
+		/// Number of values in the accumulator and the hidden layer.
+		static const unsigned int hidden = 32;
+		/// Right shift of the sums of the hidden layer.
+		static const unsigned int hidden_shift = 6;
+		/// Version of the file format.
+		static const uint32_t version = 1;
+		/// Plies with an accumulator of their own, the deeper share one.
+		static const unsigned int max_ply = 128;
+
+	private:
+		/// The accumulator of a ply and the position it is for.
+		struct frame
+		{
+			int16_t _accumulator[hidden] __attribute__((aligned(32)));
+			/// The pieces of each of the four planes of inputs.
+			bitboard _planes[4];
+			/// The generation() of the weights, 0 before built.
+			unsigned int _generation;
+		};
+
+		/// Split the pieces of @e board into the planes of inputs.
+		static void split(const board& board, bitboard* planes);
+		/** @brief Number of inputs to change to bring @e frame to
+		 *   @e planes, more than any board has pieces when stale.
+		 */
+		static unsigned int distance(const frame& frame,
+			const bitboard* planes);
+		/// Bring @e frame to @e planes input by input.
+		static void update(frame& frame, const bitboard* planes);
+		/// The value of the accumulator for the player to move.
+		static int forward(const board& board,
+			const int16_t* accumulator);
+		/// Clip the accumulator into the inputs of the hidden layer.
+		static void clip(const int16_t* accumulator, uint8_t* out);
+		/// The hidden layer.
+		static void propagate(const uint8_t* in, uint8_t* out);
+		/// The output layer, the value for Black.
+		static int output(const uint8_t* in);
+
+		static bool _enabled;
+		static unsigned int _generation;
+		/// The accumulators of the search, one per ply.
+		static frame _stack[max_ply];
+
+		static int16_t _input_weights[inputs][hidden]
+			__attribute__((aligned(32)));
+		static int16_t _input_biases[hidden]
+			__attribute__((aligned(32)));
+		/// Weights of the hidden layer, a row of inputs per output.
+		static int8_t _hidden_weights[hidden][hidden]
+			__attribute__((aligned(32)));
+		static int32_t _hidden_biases[hidden]
+			__attribute__((aligned(32)));
+		static int8_t _output_weights[hidden]
+			__attribute__((aligned(32)));
+		static int32_t _output_bias;
+		/// The weights are reset during static initialization.
+		static const bool _initialized;
+
+		/// Reset the weights.  @return Always true.
+		static bool initialize(void);
+	};
+}
+
+#include "nnue_i.hpp"
+#endif // __NNUE_HPP__
+// End of file
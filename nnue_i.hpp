@@ -0,0 +1,85 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file nnue_i.hpp
+ *  @brief Artificial intelligence, efficiently updatable neural network.
+ */
+
+#ifndef __NNUE_I_HPP__
+#define __NNUE_I_HPP__
+
+namespace checkers
+{
+	inline bool nnue::is_enabled(void)
+	{
+		return nnue::_enabled;
+	}
+
+	inline unsigned int nnue::generation(void)
+	{
+		return nnue::_generation;
+	}
+
+	inline unsigned int nnue::feature(unsigned int color, bool is_king,
+		bitboard square)
+	{
+		return (color * 2 + (is_king ? 1 : 0)) * 32 + square.ntz();
+	}
+
+	/**  The loops over the accumulator are short and simple enough for
+	 *   the compiler to vectorize.
+	 */
+	inline void nnue::add(int16_t* accumulator, unsigned int feature)
+	{
+		const int16_t* weights = nnue::_input_weights[feature];
+
+		for (unsigned int i = 0; i < nnue::hidden; ++i)
+		{
+			accumulator[i] += weights[i];
+		}
+	}
+
+	inline void nnue::remove(int16_t* accumulator, unsigned int feature)
+	{
+		const int16_t* weights = nnue::_input_weights[feature];
+
+		for (unsigned int i = 0; i < nnue::hidden; ++i)
+		{
+			accumulator[i] -= weights[i];
+		}
+	}
+
+	inline void nnue::replace(int16_t* accumulator, unsigned int from,
+		unsigned int to)
+	{
+		const int16_t* removed = nnue::_input_weights[from];
+		const int16_t* added = nnue::_input_weights[to];
+
+		for (unsigned int i = 0; i < nnue::hidden; ++i)
+		{
+			accumulator[i] += added[i] - removed[i];
+		}
+	}
+}
+
+#endif // __NNUE_I_HPP__
+// End of file
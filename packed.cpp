@@ -0,0 +1,167 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file packed.cpp
+ *  @brief Compact binary datasets of positions.
+ */
+
+extern "C"
+{
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+}
+#include <cstring>
+#include <stdexcept>
+#include "packed.hpp"
+
+namespace checkers
+{
+	namespace
+	{
+		const char MAGIC[4] = { 'P', 'A', 'C', 'K' };
+		/// Bytes of the header, the magic, version and size.
+		const size_t HEADER = 16;
+		/// The records are read from the file as they are.
+		typedef char record_size[sizeof(packed::record) == 16 ? 1 : -1];
+	}
+
+	packed::writer::writer(const std::string& filename) :
+		_filename(filename), _file(filename.c_str(),
+		std::ios::out | std::ios::binary | std::ios::trunc), _size(0)
+	{
+		const uint32_t version = packed::version;
+		const uint64_t size = 0;
+
+		// The size is written by close().
+		this->_file.write(MAGIC, sizeof(MAGIC));
+		this->_file.write(reinterpret_cast<const char*>(&version),
+			sizeof(version));
+		this->_file.write(reinterpret_cast<const char*>(&size),
+			sizeof(size));
+		if (!this->_file)
+		{
+			/// @throw std::runtime_error when the file cannot be
+			///  created.
+			throw std::runtime_error(
+				"Error (cannot write packed dataset): " + filename);
+		}
+	}
+
+	/**  The errors are lost, close() tells them.
+	 */
+	packed::writer::~writer(void)
+	{
+		if (this->_file.is_open())
+		{
+			try
+			{
+				this->close();
+			}
+			catch (const std::runtime_error&)
+			{
+			}
+		}
+	}
+
+	void packed::writer::close(void)
+	{
+		this->_file.seekp(sizeof(MAGIC) + sizeof(uint32_t));
+		this->_file.write(reinterpret_cast<const char*>(&this->_size),
+			sizeof(this->_size));
+		this->_file.close();
+		if (!this->_file)
+		{
+			/// @throw std::runtime_error when the file cannot be
+			///  written.
+			throw std::runtime_error(
+				"Error (cannot write packed dataset): " +
+				this->_filename);
+		}
+	}
+
+	packed::packed(const std::string& filename) :
+		_map(NULL), _length(0), _records(NULL), _size(0)
+	{
+		const int fd = ::open(filename.c_str(), O_RDONLY);
+		struct stat status;
+
+		if (fd < 0 || fstat(fd, &status) < 0)
+		{
+			if (fd >= 0)
+			{
+				::close(fd);
+			}
+			/// @throw std::runtime_error when the file cannot be
+			///  opened.
+			throw std::runtime_error(
+				"Error (cannot open packed dataset): " + filename);
+		}
+		this->_length = status.st_size;
+		this->_map = this->_length ? mmap(NULL, this->_length,
+			PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+		::close(fd);
+		if (MAP_FAILED == this->_map)
+		{
+			/// @throw std::runtime_error when the file cannot be
+			///  mapped.
+			throw std::runtime_error(
+				"Error (cannot map packed dataset): " + filename);
+		}
+
+		const char* const map = static_cast<const char*>(this->_map);
+		uint32_t version = 0;
+
+		if (packed::is_packed(map, this->_length))
+		{
+			std::memcpy(&version, map + sizeof(MAGIC), sizeof(version));
+			std::memcpy(&this->_size, map + sizeof(MAGIC) +
+				sizeof(version), sizeof(this->_size));
+		}
+		if (!packed::is_packed(map, this->_length) ||
+			packed::version != version ||
+			(this->_length - HEADER) % sizeof(record) != 0 ||
+			(this->_length - HEADER) / sizeof(record) != this->_size)
+		{
+			munmap(this->_map, this->_length);
+			/// @throw std::runtime_error when the file is not a
+			///  packed dataset of this version, or is cut short.
+			throw std::runtime_error(
+				"Error (bad packed dataset): " + filename);
+		}
+		this->_records = reinterpret_cast<const record*>(map + HEADER);
+	}
+
+	packed::~packed(void)
+	{
+		munmap(this->_map, this->_length);
+	}
+
+	bool packed::is_packed(const char* data, size_t length)
+	{
+		return length >= HEADER &&
+			0 == std::memcmp(data, MAGIC, sizeof(MAGIC));
+	}
+}
+
+// End of file
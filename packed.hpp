@@ -0,0 +1,139 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file packed.hpp
+ *  @brief Compact binary datasets of positions.
+ */
+
+#ifndef __PACKED_HPP__
+#define __PACKED_HPP__
+
+extern "C"
+{
+	#include <stddef.h>
+	#include <stdint.h>
+}
+#include <fstream>
+#include <string>
+
+namespace checkers
+{
+	/** @class packed
+	 *  @brief A dataset of positions as records of 16 bytes, mapped
+	 *   into memory and read by index without parsing.
+	 *
+	 *   The file is the magic "PACK", the version and the number of
+	 *   records, then the records in the byte order of the machine.
+	 *   A record is the three bitboards, the score, the player to
+	 *   move and the result, a tenth of the size of a line of FEN.
+	 */
+	class packed
+	{
+	public:
+		/// A position of the dataset.
+		struct record
+		{
+			uint32_t black;
+			uint32_t white;
+			uint32_t kings;
+			/** @brief Value of the position for the player to move,
+			 *   or no_score.
+			 */
+			int16_t score;
+			/// 1 when Black is to move, 0 when White.
+			uint8_t black_to_move;
+			/// The result in half points for Black, -1 when unknown.
+			int8_t result;
+		};
+
+		/// Write a packed dataset record by record.
+		class writer
+		{
+		public:
+			/** @brief Create @e filename.
+			 *  @throw std::runtime_error when it cannot be created.
+			 */
+			explicit writer(const std::string& filename);
+			/// Close the file, if not closed yet.
+			~writer(void);
+
+			/// Append @e record.
+			inline void write(const record& record);
+			/// Get the number of records written.
+			inline uint64_t size(void) const;
+			/** @brief Write the number of records into the header
+			 *   and close the file.
+			 *  @throw std::runtime_error when the file cannot be
+			 *   written.
+			 */
+			void close(void);
+
+		private:
+			writer(const writer&);
+			writer& operator =(const writer&);
+
+			std::string _filename;
+			std::ofstream _file;
+			uint64_t _size;
+		};
+
+		/// Version of the file.
+		static const uint32_t version = 1;
+		/// Score of a position which has none.
+		static const int16_t no_score = -32768;
+
+		/** @brief Map @e filename into memory.
+		 *  @throw std::runtime_error when the file cannot be read, or
+		 *   is no packed dataset.
+		 */
+		explicit packed(const std::string& filename);
+		~packed(void);
+
+		/// Get the number of records.
+		inline uint64_t size(void) const;
+		/// Get the record of @e index, from 0.
+		inline const record& operator [](uint64_t index) const;
+
+		/** @brief Whether the @e length bytes of @e data begin as a
+		 *   packed dataset, by the magic.
+		 */
+		static bool is_packed(const char* data, size_t length);
+		/** @brief Get @e score cut to the range of a record, with
+		 *   no_score kept.
+		 */
+		inline static int16_t to_score(int score);
+
+	private:
+		packed(const packed&);
+		packed& operator =(const packed&);
+
+		/// The file mapped into memory.
+		void* _map;
+		size_t _length;
+		const record* _records;
+		uint64_t _size;
+	};
+}
+
+#include "packed_i.hpp"
+#endif // __PACKED_HPP__
+// End of file
@@ -0,0 +1,69 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file packed_i.hpp
+ *  @brief Compact binary datasets of positions.
+ */
+
+#ifndef __PACKED_I_HPP__
+#define __PACKED_I_HPP__
+
+#include <cassert>
+
+namespace checkers
+{
+	inline uint64_t packed::size(void) const
+	{
+		return this->_size;
+	}
+
+	inline const packed::record& packed::operator [](uint64_t index)
+		const
+	{
+		assert(index < this->_size);
+
+		return this->_records[index];
+	}
+
+	inline int16_t packed::to_score(int score)
+	{
+		return int16_t(score < -32767 && packed::no_score != score ?
+			-32767 : score > 32767 ? 32767 : score);
+	}
+
+	// ================================================================
+
+	inline void packed::writer::write(const record& record)
+	{
+		this->_file.write(reinterpret_cast<const char*>(&record),
+			sizeof(record));
+		++this->_size;
+	}
+
+	inline uint64_t packed::writer::size(void) const
+	{
+		return this->_size;
+	}
+}
+
+#endif // __PACKED_I_HPP__
+// End of file
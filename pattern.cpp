@@ -0,0 +1,286 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file pattern.cpp
+ *  @brief Artificial intelligence, evaluation by pattern tables.
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include "evaluate.hpp"
+#include "pattern.hpp"
+
+namespace checkers
+{
+	namespace
+	{
+		/// Tag at the beginning of a file of tables.
+		const char MAGIC[4] = { 'P', 'T', 'R', 'N' };
+
+		/// Linear value for Black of a piece in @e state on @e square.
+		int square_value(unsigned int square, unsigned int state)
+		{
+			const uint32_t bit = 0x1U << square;
+			const bool is_black = state < 3;
+			int val;
+
+			if (0 == state)
+			{
+				return 0;
+			}
+			val = 1 == state || 3 == state ?
+				evaluate::get_weights().man :
+				evaluate::get_weights().king;
+			if (bit & (is_black ? bitboard::WHITE_KINGS_ROW :
+				bitboard::BLACK_KINGS_ROW))
+			{
+				val += evaluate::get_weights().kings_row;
+			}
+			if (bit & bitboard::EDGES)
+			{
+				val += evaluate::get_weights().edge;
+			}
+			return is_black ? val : -val;
+		}
+	}
+
+	/**  The configuration of each region is 3 configurations of pairs
+	 *   of squares, one for each row, and the 3 pairs of a row are
+	 *   looked up once for all regions.
+	 */
+	int pattern::evaluate(const board& board)
+	{
+		assert(pattern::regions * pattern::entries ==
+			pattern::_tables.size());
+
+		const uint32_t black = board.get_black_pieces().bits();
+		const uint32_t white = board.get_white_pieces().bits();
+		const uint32_t kings = board.get_kings().bits();
+		unsigned int pairs[8][3];
+
+		for (unsigned int row = 0; row < 8; ++row)
+		{
+			for (unsigned int column = 0; column < 3; ++column)
+			{
+				const unsigned int shift = row * 4 + column;
+				pairs[row][column] = pattern::_pairs[
+					(black >> shift & 0x3U) |
+					(white >> shift & 0x3U) << 2 |
+					(kings >> shift & 0x3U) << 4];
+			}
+		}
+
+		const int16_t* table = &pattern::_tables[0];
+		int val = 0;
+
+		for (unsigned int column = 0; column < 3; ++column)
+		{
+			for (unsigned int row = 0; row < 6; ++row)
+			{
+				val += table[pairs[row][column] +
+					25 * pairs[row + 1][column] +
+					625 * pairs[row + 2][column]];
+				table += pattern::entries;
+			}
+		}
+
+		return (board.is_black_to_move() ? val : -val) +
+			evaluate::movers(board) * evaluate::get_weights().mover;
+	}
+
+	/**  Every square is counted by one region only, the one with the
+	 *   lowest row and column positions still covering it.
+	 */
+	void pattern::reset(void)
+	{
+		std::vector<int16_t> tables(pattern::regions * pattern::entries);
+
+		for (unsigned int column = 0; column < 3; ++column)
+		{
+			for (unsigned int row = 0; row < 6; ++row)
+			{
+				int16_t* table = &tables[(column * 6 + row) *
+					pattern::entries];
+
+				for (unsigned int i = 0; i < pattern::entries; ++i)
+				{
+					unsigned int code = i;
+					int val = 0;
+
+					for (unsigned int j = 0;
+						j < pattern::region_squares; ++j)
+					{
+						const unsigned int square_row =
+							row + j / 2;
+						const unsigned int square_column =
+							column + j % 2;
+
+						if (std::min(square_row, 5U) == row &&
+							std::min(square_column, 2U) ==
+							column)
+						{
+							val += square_value(square_row * 4 +
+								square_column, code % 5);
+						}
+						code /= 5;
+					}
+					if (val < -32768 || val > 32767)
+					{
+						/// @throw std::runtime_error when
+						///  the weights do not fit in 16
+						///  bits.
+						throw std::runtime_error("Error"
+							" (weights too large for"
+							" pattern tables)");
+					}
+					table[i] = int16_t(val);
+				}
+			}
+		}
+
+		pattern::_tables.swap(tables);
+		pattern::_enabled = true;
+	}
+
+	/**  The file is the tag "PTRN", then the version, the number of
+	 *   regions and the number of entries per region as 32-bit
+	 *   integers, then the 16-bit weights of the regions one after
+	 *   another.  The regions go by column position, then by row
+	 *   position.  Within a region, the configuration of the lowest
+	 *   row is the least significant digit of the index in base 25,
+	 *   and within a row, the lower square is the least significant
+	 *   digit in base 5.  The digits are 0 for an empty square, 1 for
+	 *   a black man, 2 for a black king, 3 for a white man and 4 for a
+	 *   white king.  Integers are in the byte order of the host.
+	 *
+	 *   The tables in use are kept when the file is bad.
+	 */
+	void pattern::load(const std::string& filename)
+	{
+		std::ifstream file(filename.c_str(),
+			std::ios::in | std::ios::binary);
+		char magic[sizeof(MAGIC)];
+		uint32_t header[3];
+		std::vector<int16_t> tables(pattern::regions * pattern::entries);
+
+		if (!file)
+		{
+			/// @throw std::runtime_error when the file cannot be
+			///  opened.
+			throw std::runtime_error(
+				"Error (cannot open pattern file): " + filename);
+		}
+		file.read(magic, sizeof(magic));
+		file.read(reinterpret_cast<char*>(header), sizeof(header));
+		if (!file || 0 != std::memcmp(magic, MAGIC, sizeof(MAGIC)) ||
+			pattern::version != header[0] ||
+			pattern::regions != header[1] ||
+			pattern::entries != header[2])
+		{
+			/// @throw std::runtime_error when the header is wrong.
+			throw std::runtime_error(
+				"Error (bad pattern file header): " + filename);
+		}
+		file.read(reinterpret_cast<char*>(&tables[0]),
+			tables.size() * sizeof(tables[0]));
+		if (!file || EOF != file.peek())
+		{
+			/// @throw std::runtime_error when the file is too short
+			///  or too long.
+			throw std::runtime_error(
+				"Error (bad pattern file size): " + filename);
+		}
+
+		pattern::_tables.swap(tables);
+		pattern::_enabled = true;
+	}
+
+	void pattern::save(const std::string& filename)
+	{
+		if (pattern::_tables.empty())
+		{
+			pattern::reset();
+			pattern::_enabled = false;
+		}
+
+		std::ofstream file(filename.c_str(),
+			std::ios::out | std::ios::binary | std::ios::trunc);
+		const uint32_t header[3] =
+		{
+			pattern::version, pattern::regions, pattern::entries
+		};
+
+		file.write(MAGIC, sizeof(MAGIC));
+		file.write(reinterpret_cast<const char*>(header),
+			sizeof(header));
+		file.write(reinterpret_cast<const char*>(&pattern::_tables[0]),
+			pattern::_tables.size() * sizeof(pattern::_tables[0]));
+		file.close();
+		if (!file)
+		{
+			/// @throw std::runtime_error when the file cannot be
+			///  written.
+			throw std::runtime_error(
+				"Error (cannot write pattern file): " + filename);
+		}
+	}
+
+	/**  The lower square of a pair is the least significant digit in
+	 *   base 5.
+	 *  @return Always true.
+	 */
+	bool pattern::build_pairs(void)
+	{
+		for (unsigned int i = 0; i < 64; ++i)
+		{
+			unsigned int code = 0;
+
+			for (unsigned int j = 2; j-- > 0; )
+			{
+				const bool is_king = i >> (4 + j) & 0x1U;
+
+				code *= 5;
+				if (i >> j & 0x1U)
+				{
+					code += is_king ? 2 : 1;
+				}
+				else if (i >> (2 + j) & 0x1U)
+				{
+					code += is_king ? 4 : 3;
+				}
+			}
+			pattern::_pairs[i] = uint8_t(code);
+		}
+		return true;
+	}
+
+	bool pattern::_enabled = false;
+	std::vector<int16_t> pattern::_tables;
+	uint8_t pattern::_pairs[64];
+	const bool pattern::_built = pattern::build_pairs();
+}
+
+// End of file
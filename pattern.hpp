@@ -0,0 +1,103 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file pattern.hpp
+ *  @brief Artificial intelligence, evaluation by pattern tables.
+ */
+
+#ifndef __PATTERN_HPP__
+#define __PATTERN_HPP__
+
+extern "C"
+{
+	#include <stdint.h>
+}
+#include <string>
+#include <vector>
+#include "board.hpp"
+
+namespace checkers
+{
+	/** @class pattern
+	 *  @brief Evaluate a board by looking up the configurations of
+	 *   board regions in weight tables.
+	 *
+	 *   A region is 3 rows by 2 columns of the 4 squares in a row, so
+	 *   6 squares, and regions overlap each other.  There are 6 row
+	 *   positions and 3 column positions, 18 regions in all.  Each
+	 *   square is empty or has a black man, a black king, a white man
+	 *   or a white king, so the configuration of a region indexes a
+	 *   table of 5^6 weights from the point of view of Black.  The
+	 *   mobility term of the linear evaluation is added, because it
+	 *   does not decompose into regions.
+	 *
+	 *   The default tables spread the linear terms for the pieces over
+	 *   the regions, by the weights at the time of reset(), so they
+	 *   evaluate exactly like evaluate::linear().
+	 *   Tuned tables are loaded from a binary file.
+	 */
+	class pattern
+	{
+	public:
+		/// Value of @e board for the player to move.
+		static int evaluate(const board& board);
+
+		/// Whether evaluate::evaluate() uses the tables.
+		inline static bool is_enabled(void);
+		/// Evaluate with the linear terms again.
+		inline static void disable(void);
+		/// Fill the tables with the default weights, and use them.
+		static void reset(void);
+		/// Read the tables from @e filename, and use them.
+		static void load(const std::string& filename);
+		/// Write the tables to @e filename.
+		static void save(const std::string& filename);
+
+		/// Number of regions.
+		static const unsigned int regions = 18;
+		/// Number of squares in a region.
+		static const unsigned int region_squares = 6;
+		/// Number of entries in the table of a region, 5^6.
+		static const unsigned int entries = 15625;
+		/// Version of the file format.
+		static const uint32_t version = 1;
+
+	private:
+		/// Whether to use the tables.
+		static bool _enabled;
+		/// The tables of all regions one after another.
+		static std::vector<int16_t> _tables;
+		/** @brief Configuration of 2 squares in a row from 6 bits, 2
+		 *   of the black pieces, 2 of the white pieces and 2 of the
+		 *   kings.
+		 */
+		static uint8_t _pairs[64];
+		/// The table of pairs is built during static initialization.
+		static const bool _built;
+
+		static bool build_pairs(void);
+	};
+}
+
+#include "pattern_i.hpp"
+#endif // __PATTERN_HPP__
+// End of file
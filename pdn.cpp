@@ -0,0 +1,288 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file pdn.cpp
+ *  @brief Portable Draughts Notation.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include "pdn.hpp"
+
+namespace checkers
+{
+	namespace
+	{
+		/// Whether @e c ends a token of the move text.
+		inline bool is_delimiter(int c)
+		{
+			return std::isspace(c) || '[' == c || '{' == c ||
+				'(' == c || ';' == c;
+		}
+	}
+
+	pdn::pdn(std::istream& is) :
+		_is(is)
+	{
+	}
+
+	/**  A game ends at its result, or where the tags of the next game
+	 *   begin.
+	 */
+	bool pdn::next(game& game)
+	{
+		bool found = false;
+		bool moves = false;
+		int c;
+
+		game.fen.clear();
+		game.result = -1;
+		game.turns.clear();
+		while ((c = this->_is.peek()) != EOF)
+		{
+			if (std::isspace(c))
+			{
+				this->_is.get();
+			}
+			else if ('[' == c)
+			{
+				if (moves)
+				{
+					return true;
+				}
+				this->read_tag(game);
+				found = true;
+			}
+			else if ('{' == c)
+			{
+				this->skip('{', '}');
+			}
+			else if ('(' == c)
+			{
+				this->skip('(', ')');
+			}
+			else if (';' == c)
+			{
+				this->skip('\n', '\n');
+			}
+			else
+			{
+				std::string token;
+
+				while (c != EOF && !is_delimiter(c))
+				{
+					token += char(this->_is.get());
+					c = this->_is.peek();
+				}
+
+				const int result = pdn::parse_result(token);
+				if (result >= 0 || "*" == token)
+				{
+					if (game.result < 0)
+					{
+						game.result = result;
+					}
+					return true;
+				}
+
+				// The move number may stick to the turn, as "1.11-15".
+				const std::string::size_type dot =
+					token.find_last_of('.');
+				if (dot != std::string::npos)
+				{
+					token.erase(0, dot + 1);
+				}
+				const std::string::size_type end =
+					token.find_last_not_of("!?");
+				token.erase(std::string::npos == end ? 0 : end + 1);
+				if (!token.empty() && '$' != token[0])
+				{
+					game.turns.push_back(token);
+					moves = true;
+				}
+				found = true;
+			}
+		}
+		return found;
+	}
+
+	int pdn::parse_result(const std::string& text)
+	{
+		if ("1-0" == text || "2-0" == text)
+		{
+			return 2;
+		}
+		else if ("0-1" == text || "0-2" == text)
+		{
+			return 0;
+		}
+		else if ("1/2-1/2" == text || "1-1" == text)
+		{
+			return 1;
+		}
+		return -1;
+	}
+
+	bool pdn::parse_turn(const board& board, const std::string& text,
+		std::vector<move>& turn)
+	{
+		std::vector<unsigned int> squares;
+		std::string::size_type p = 0;
+
+		turn.clear();
+		for (;;)
+		{
+			unsigned int square = 0;
+			const std::string::size_type begin = p;
+
+			while (p < text.size() && std::isdigit(text[p]) &&
+				square <= 32)
+			{
+				square = square * 10 + (text[p++] - '0');
+			}
+			if (p == begin || 0 == square || square > 32)
+			{
+				return false;
+			}
+			squares.push_back(square - 1);
+			if (p == text.size())
+			{
+				break;
+			}
+			if ('-' != text[p] && 'x' != text[p])
+			{
+				return false;
+			}
+			++p;
+		}
+		if (squares.size() < 2)
+		{
+			return false;
+		}
+
+		checkers::board next(board);
+		std::vector<move> moves;
+
+		pdn::match(next, bitboard(bitboard::EMPTY), squares, 0, moves,
+			turn);
+		return !turn.empty();
+	}
+
+	void pdn::skip(char begin, char end)
+	{
+		unsigned int depth = 0;
+		int c;
+
+		this->_is.get();
+		while ((c = this->_is.get()) != EOF)
+		{
+			if (end == c && 0 == depth--)
+			{
+				break;
+			}
+			depth += begin == c && begin != end;
+		}
+	}
+
+	/**  A tag is as [Name "Value"].
+	 */
+	void pdn::read_tag(game& game)
+	{
+		std::string tag;
+		int c;
+
+		this->_is.get();
+		while ((c = this->_is.get()) != EOF && ']' != c)
+		{
+			tag += char(c);
+			if ('"' == c)
+			{
+				while ((c = this->_is.get()) != EOF && '"' != c)
+				{
+					tag += char(c);
+				}
+				tag += '"';
+			}
+		}
+
+		const std::string::size_type space = tag.find_first_of(" \t");
+		const std::string::size_type first = tag.find('"');
+		const std::string::size_type last = tag.rfind('"');
+		if (std::string::npos == first || first == last)
+		{
+			return;
+		}
+
+		const std::string name = tag.substr(0, std::min(space, first));
+		const std::string value = tag.substr(first + 1,
+			last - first - 1);
+		if ("FEN" == name)
+		{
+			game.fen = value;
+		}
+		else if ("Result" == name)
+		{
+			game.result = pdn::parse_result(value);
+		}
+	}
+
+	/**  The first square is the source, and the others are passed in
+	 *   order, the last at the end of the turn.
+	 */
+	void pdn::match(board& board, bitboard jumper,
+		const std::vector<unsigned int>& squares, size_t next,
+		std::vector<move>& moves, std::vector<move>& turn)
+	{
+		const std::vector<move> choices = jumper ?
+			board.generate_jumps(jumper) : board.generate_moves();
+
+		for (std::vector<move>::const_iterator pos = choices.begin();
+			turn.empty() && pos != choices.end(); ++pos)
+		{
+			if (!jumper && pos->get_src().ntz() != squares[0])
+			{
+				continue;
+			}
+
+			const size_t passed = next + 1 < squares.size() &&
+				pos->get_dest().ntz() == squares[next + 1] ?
+				next + 1 : next;
+
+			moves.push_back(*pos);
+			if (board.make_move(*pos))
+			{
+				pdn::match(board, pos->get_dest(), squares, passed,
+					moves, turn);
+			}
+			else if (passed + 1 == squares.size() &&
+				pos->get_dest().ntz() == squares.back())
+			{
+				turn = moves;
+			}
+			board.undo_move(*pos);
+			moves.pop_back();
+		}
+	}
+}
+
+// End of file
@@ -0,0 +1,105 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file pdn.hpp
+ *  @brief Portable Draughts Notation.
+ */
+
+#ifndef __PDN_HPP__
+#define __PDN_HPP__
+
+#include <istream>
+#include <string>
+#include <vector>
+#include "board.hpp"
+
+namespace checkers
+{
+	/** @class pdn
+	 *  @brief Read the games of a file in Portable Draughts Notation,
+	 *   one by one, so that a large collection is never all in
+	 *   memory.
+	 *
+	 *   Of the tags only FEN, the position the game begins from, and
+	 *   Result are kept.  The move numbers, comments, variations and
+	 *   annotations are skipped.
+	 */
+	class pdn
+	{
+	public:
+		/// A game of the file.
+		struct game
+		{
+			/** @brief The position the game begins from, empty for
+			 *   the initial position.
+			 */
+			std::string fen;
+			/// The result in half points for Black, -1 when unknown.
+			int result;
+			/// The turns as written, e.g. "11-15" or "22x15x8".
+			std::vector<std::string> turns;
+		};
+
+		explicit pdn(std::istream& is);
+
+		/** @brief Read the next game.
+		 *  @return false at the end of the file.
+		 */
+		bool next(game& game);
+
+		/** @brief Get the result in half points for Black of
+		 *   @e text, as "1-0", "0-1" or "1/2-1/2", or as "2-0",
+		 *   "0-2" or "1-1".
+		 *  @return The result, or -1 when @e text is no result.
+		 */
+		static int parse_result(const std::string& text);
+		/** @brief Find the turn of @e text, the squares from 1
+		 *   joined by '-' or 'x', where the squares a jump passes may
+		 *   be left out.
+		 *  @param turn The moves of the turn, the jumps of a
+		 *   multiple jump one by one.
+		 *  @return Whether the turn is legal on @e board.
+		 */
+		static bool parse_turn(const board& board,
+			const std::string& text, std::vector<move>& turn);
+
+	private:
+		/// Skip up to and over @e end, with nested @e begin.
+		void skip(char begin, char end);
+		/// Read a tag into @e game.
+		void read_tag(game& game);
+
+		/** @brief Look through the turns from the piece @e jumper
+		 *   jumping once more if not empty, for the first to pass
+		 *   @e squares from @e next on.
+		 *  @param moves The moves of the turn so far.
+		 */
+		static void match(board& board, bitboard jumper,
+			const std::vector<unsigned int>& squares, size_t next,
+			std::vector<move>& moves, std::vector<move>& turn);
+
+		std::istream& _is;
+	};
+}
+
+#endif // __PDN_HPP__
+// End of file
@@ -0,0 +1,362 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file perft.cpp
+ *  @brief Move generation test, counting the leaf nodes of the game tree.
+ */
+
+extern "C"
+{
+	#include <pthread.h>
+}
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include "perft.hpp"
+
+namespace checkers
+{
+	/** @return The number of positions after @e depth whole turns,
+	 *   games ended before do not count.
+	 */
+	uint64_t perft::count(const board& board, unsigned int depth,
+		unsigned int threads)
+	{
+		std::vector<std::vector<move> > turns;
+		std::vector<uint64_t> counts;
+		uint64_t nodes = 0;
+
+		if (0 == depth)
+		{
+			return 1;
+		}
+		perft::run(board, depth, threads, turns, counts);
+		for (std::vector<uint64_t>::size_type i = 0; i < counts.size();
+			++i)
+		{
+			nodes += counts[i];
+		}
+		return nodes;
+	}
+
+	/** @return One line per turn with its count, and the summary of
+	 *   all.
+	 */
+	std::string perft::divide(const board& board, unsigned int depth,
+		unsigned int threads)
+	{
+		std::ostringstream stream;
+		std::vector<std::vector<move> > turns;
+		std::vector<uint64_t> counts;
+		uint64_t nodes = 0;
+		struct timeval time = timeval::now();
+
+		perft::run(board, std::max(depth, 1U), threads, turns, counts);
+		time = timeval::now() - time;
+
+		for (std::vector<std::vector<move> >::size_type i = 0;
+			i < turns.size(); ++i)
+		{
+			std::ostringstream name;
+
+			for (std::vector<move>::const_iterator hop =
+				turns[i].begin(); hop != turns[i].end(); ++hop)
+			{
+				if (turns[i].begin() == hop)
+				{
+					name << *hop;
+				}
+				else
+				{
+					name << 'x' << hop->get_dest();
+				}
+			}
+			nodes += counts[i];
+			stream << "  " << std::setw(12) << std::left <<
+				name.str() << std::right << std::setw(16) <<
+				counts[i] << '\n';
+		}
+
+		stream << "  moves       " << std::setw(16) << turns.size() <<
+			'\n' << perft::report(nodes, time);
+		return stream.str();
+	}
+
+	/** @param megabytes The size is rounded down to a power of 2
+	 *   entries.
+	 */
+	void perft::set_hash_size(unsigned int megabytes)
+	{
+		std::vector<entry>::size_type size = 1;
+		const std::vector<entry>::size_type limit =
+			std::vector<entry>::size_type(megabytes) * 1024 * 1024 /
+			sizeof(entry);
+
+		if (0 == megabytes)
+		{
+			std::vector<entry>().swap(perft::_hash);
+			return;
+		}
+		while (size * 2 <= limit)
+		{
+			size *= 2;
+		}
+		std::vector<entry>(size).swap(perft::_hash);
+	}
+
+	std::string perft::report(uint64_t nodes, struct timeval time)
+	{
+		std::ostringstream stream;
+		const double seconds = time.tv_sec + time.tv_usec / 1e6;
+
+		stream << "  nodes       " << std::setw(16) << nodes << "\n"
+			"  time        " << std::setw(12) << time.tv_sec << '.' <<
+			std::setw(3) << std::setfill('0') <<
+			(time.tv_usec / 1000) << std::setfill(' ') << "\n"
+			"  nodes/second" << std::setw(16) <<
+			uint64_t(seconds > 0 ? nodes / seconds : 0.0) << '\n';
+		return stream.str();
+	}
+
+	// ================================================================
+
+	/** @param depth At least 1.
+	 *  @param turns The turns of @e board.
+	 *  @param counts The count after each of @e turns.
+	 */
+	void perft::run(const board& board, unsigned int depth,
+		unsigned int threads, std::vector<std::vector<move> >& turns,
+		std::vector<uint64_t>& counts)
+	{
+		std::vector<move> turn;
+		std::vector<task> tasks;
+		std::vector<std::vector<move> >::size_type i;
+		perft root(board);
+
+		if (threads < 1)
+		{
+			threads = 1;
+		}
+		else if (threads > perft::max_threads)
+		{
+			threads = perft::max_threads;
+		}
+
+		root.generate_turns(turns, turn, bitboard(bitboard::EMPTY));
+		// With few turns at the root, split at the second ply to keep
+		// all the threads busy.
+		const bool split = threads > 1 && depth > 2 &&
+			turns.size() < 4 * threads;
+		for (i = 0; i < turns.size(); ++i)
+		{
+			task task;
+			task._root = i;
+			task._hops = turns[i];
+			task._nodes = 0;
+			if (!split)
+			{
+				tasks.push_back(task);
+				continue;
+			}
+
+			std::vector<std::vector<move> > replies;
+			std::vector<move>::const_iterator hop;
+			for (hop = turns[i].begin(); hop != turns[i].end(); ++hop)
+			{
+				root._board.make_move(*hop);
+			}
+			root.generate_turns(replies, turn,
+				bitboard(bitboard::EMPTY));
+			for (hop = turns[i].end(); hop != turns[i].begin(); )
+			{
+				root._board.undo_move(*--hop);
+			}
+
+			for (std::vector<std::vector<move> >::const_iterator
+				pos = replies.begin(); pos != replies.end(); ++pos)
+			{
+				task._hops = turns[i];
+				task._hops.insert(task._hops.end(), pos->begin(),
+					pos->end());
+				tasks.push_back(task);
+			}
+		}
+
+		work work;
+		work._board = &board;
+		work._tasks = &tasks;
+		work._depth = depth - (split ? 2 : 1);
+		work._next = 0;
+		if (1 == threads)
+		{
+			perft::worker(&work);
+		}
+		else
+		{
+			pthread_t tids[perft::max_threads];
+			unsigned int j;
+			int err = 0;
+
+			for (j = 0; j < threads; ++j)
+			{
+				if ((err = pthread_create(&tids[j], NULL,
+					&perft::worker, &work)) != 0)
+				{
+					// Let the running threads finish the
+					// work.
+					threads = j;
+					break;
+				}
+			}
+			for (j = 0; j < threads; ++j)
+			{
+				pthread_join(tids[j], NULL);
+			}
+			if (0 == threads)
+			{
+				/// @throw std::runtime_error when
+				///  pthread_create() failed.
+				throw std::runtime_error(
+					std::string("pthread_create() failed: ")
+					+ std::strerror(err));
+			}
+		}
+
+		counts.assign(turns.size(), 0);
+		for (std::vector<task>::const_iterator pos = tasks.begin();
+			pos != tasks.end(); ++pos)
+		{
+			counts[pos->_root] += pos->_nodes;
+		}
+	}
+
+	void* perft::worker(void* arg)
+	{
+		work& work = *static_cast<perft::work*>(arg);
+		perft perft(*work._board);
+		unsigned int i;
+
+		while ((i = __sync_fetch_and_add(&work._next, 1)) <
+			work._tasks->size())
+		{
+			perft.count((*work._tasks)[i], work._depth);
+		}
+
+		return NULL;
+	}
+
+	void perft::count(task& task, unsigned int depth)
+	{
+		std::vector<move>::const_iterator hop;
+
+		for (hop = task._hops.begin(); hop != task._hops.end(); ++hop)
+		{
+			this->_board.make_move(*hop);
+		}
+		task._nodes = this->count(depth, bitboard(bitboard::EMPTY));
+		for (hop = task._hops.end(); hop != task._hops.begin(); )
+		{
+			this->_board.undo_move(*--hop);
+		}
+	}
+
+	uint64_t perft::count(unsigned int depth, bitboard jumper)
+	{
+		uint64_t nodes = 0;
+
+		if (0 == depth)
+		{
+			return 1;
+		}
+		// Transpositions only happen between whole turns
+		const bool hashed = !jumper && depth > 1 && depth <= 0xffU &&
+			!perft::_hash.empty();
+		if (hashed && this->probe_hash(depth, nodes))
+		{
+			return nodes;
+		}
+
+		// Only the jumping piece may continue
+		const std::vector<move> moves = jumper ?
+			this->_board.generate_jumps(jumper) :
+			this->_board.generate_moves();
+		// Bulk counting: a simple move always ends the turn
+		if (1 == depth && !jumper &&
+			(moves.empty() || !moves.front().get_capture()))
+		{
+			return moves.size();
+		}
+
+		for (std::vector<move>::const_iterator pos = moves.begin();
+			pos != moves.end(); ++pos)
+		{
+			if (this->_board.make_move(*pos))
+			{
+				nodes += this->count(depth, pos->get_dest());
+			}
+			else
+			{
+				nodes += this->count(depth - 1,
+					bitboard(bitboard::EMPTY));
+			}
+			this->_board.undo_move(*pos);
+		}
+
+		if (hashed)
+		{
+			this->record_hash(depth, nodes);
+		}
+		return nodes;
+	}
+
+	/** @param turn The hops made so far in the current turn.
+	 */
+	void perft::generate_turns(std::vector<std::vector<move> >& turns,
+		std::vector<move>& turn, bitboard jumper)
+	{
+		const std::vector<move> moves = jumper ?
+			this->_board.generate_jumps(jumper) :
+			this->_board.generate_moves();
+
+		for (std::vector<move>::const_iterator pos = moves.begin();
+			pos != moves.end(); ++pos)
+		{
+			turn.push_back(*pos);
+			if (this->_board.make_move(*pos))
+			{
+				this->generate_turns(turns, turn, pos->get_dest());
+			}
+			else
+			{
+				turns.push_back(turn);
+			}
+			this->_board.undo_move(*pos);
+			turn.pop_back();
+		}
+	}
+
+	std::vector<perft::entry> perft::_hash;
+}
+
+// End of file
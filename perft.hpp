@@ -0,0 +1,145 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file perft.hpp
+ *  @brief Move generation test, counting the leaf nodes of the game tree.
+ */
+
+#ifndef __PERFT_HPP__
+#define __PERFT_HPP__
+
+extern "C"
+{
+	#include <stdint.h>
+}
+#include <string>
+#include <vector>
+#include "board.hpp"
+#include "timeval.hpp"
+
+namespace checkers
+{
+	/** @class perft
+	 *  @brief Count the leaf nodes of the game tree to a fixed depth.
+	 *
+	 *   A node is a position after a whole turn, so a multiple jump
+	 *   counts once.  The counts are well known for the starting
+	 *   position, which validates the move generator, and the speed
+	 *   measures it.
+	 *
+	 *   The turns at the root, or at the second ply when there are few
+	 *   of them, are shared out to worker threads.  Each one works on
+	 *   its own copy of the board, and all of them share a lock-free
+	 *   hash table.
+	 */
+	class perft
+	{
+	public:
+		/// Count the positions @e depth turns away from @e board.
+		static uint64_t count(const board& board, unsigned int depth,
+			unsigned int threads = 1);
+		/// Count the positions after each turn of @e board.
+		static std::string divide(const board& board,
+			unsigned int depth, unsigned int threads = 1);
+
+		/** @brief Set the size of the hash table in megabytes, 0 to
+		 *   search without hash table.
+		 */
+		static void set_hash_size(unsigned int megabytes);
+
+		/// Summary of a count of @e nodes in @e time.
+		static std::string report(uint64_t nodes,
+			struct timeval time);
+
+		/// Maximum number of worker threads.
+		static const unsigned int max_threads = 64;
+
+	private:
+		/// A hash table entry, the key is stored xor-ed by the data.
+		struct entry
+		{
+			inline entry(void);
+
+			uint64_t _check;
+			/// The count in the high bits, the depth in the low.
+			uint64_t _data;
+		};
+
+		/// Count below a sequence of hops from the root.
+		struct task
+		{
+			/// Index of the root turn the hops begin with.
+			unsigned int _root;
+			std::vector<move> _hops;
+			uint64_t _nodes;
+		};
+
+		/// Tasks shared by the worker threads.
+		struct work
+		{
+			const board* _board;
+			std::vector<task>* _tasks;
+			/// Remaining depth after the hops of a task.
+			unsigned int _depth;
+			/// Index of the next task to take.
+			volatile unsigned int _next;
+		};
+
+		inline explicit perft(const board& board);
+
+		/** @brief Count the positions after each turn of @e board,
+		 *   splitting the work among @e threads.
+		 */
+		static void run(const board& board, unsigned int depth,
+			unsigned int threads,
+			std::vector<std::vector<move> >& turns,
+			std::vector<uint64_t>& counts);
+		static void* worker(void* arg);
+
+		/// Make the hops of @e task, count, and undo them.
+		void count(task& task, unsigned int depth);
+
+		/** @note This is recursive function.
+		 *  @param jumper The piece has to continue jumping, or empty
+		 *   at the beginning of a turn.
+		 */
+		uint64_t count(unsigned int depth, bitboard jumper);
+
+		/// Generate all the whole turns from the current board.
+		void generate_turns(std::vector<std::vector<move> >& turns,
+			std::vector<move>& turn, bitboard jumper);
+
+		/// Get a count from the hash table.
+		inline bool probe_hash(unsigned int depth,
+			uint64_t& nodes) const;
+		/// Store a count in the hash table.
+		inline void record_hash(unsigned int depth, uint64_t nodes);
+
+		board _board;
+
+		static std::vector<entry> _hash;
+	};
+}
+
+#include "perft_i.hpp"
+#endif // __PERFT_HPP__
+// End of file
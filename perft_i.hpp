@@ -0,0 +1,74 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file perft_i.hpp
+ *  @brief Move generation test, counting the leaf nodes of the game tree.
+ */
+
+#ifndef __PERFT_I_HPP__
+#define __PERFT_I_HPP__
+
+namespace checkers
+{
+	inline perft::entry::entry(void) :
+		_check(0), _data(0)
+	{
+	}
+
+	inline perft::perft(const board& board) :
+		_board(board)
+	{
+	}
+
+	// ================================================================
+
+	/** @return Whether the count of the current board at @e depth is
+	 *   found.
+	 */
+	inline bool perft::probe_hash(unsigned int depth,
+		uint64_t& nodes) const
+	{
+		const uint64_t key = this->_board.get_zobrist().key();
+		const entry& entry = perft::_hash[key & (perft::_hash.size() - 1)];
+		const uint64_t data = entry._data;
+
+		if ((entry._check ^ data) != key || (data & 0xffU) != depth)
+		{
+			return false;
+		}
+		nodes = data >> 8;
+		return true;
+	}
+
+	inline void perft::record_hash(unsigned int depth, uint64_t nodes)
+	{
+		const uint64_t key = this->_board.get_zobrist().key();
+		entry& entry = perft::_hash[key & (perft::_hash.size() - 1)];
+		const uint64_t data = nodes << 8 | (depth & 0xffU);
+
+		entry._check = key ^ data;
+		entry._data = data;
+	}
+}
+
+#endif // __PERFT_I_HPP__
+// End of file
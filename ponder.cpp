@@ -145,6 +145,15 @@ int main(int argc, char **argv){
 		checkers::signal(SIGSEGV, &checkers::crash_handler);
 		checkers::signal(SIGTRAP, &checkers::crash_handler);
 
+		if( argc >= 2 && std::string(argv[1]) == "BENCH" ){
+		  std::string command = "bench";
+		  for( int i = 2; i < argc; ++i ){
+		    command += std::string(" ") + argv[i];
+		  }
+		  checkers::engine::init().run_command(command);
+		  return 0;
+		}
+
 		if( argc != 3 ){std::cout << "wrong args\n"; return 0;}
 
 		std::string type(argv[1]);
@@ -53,6 +53,10 @@ namespace checkers
 			hash_flag flag, const std::vector<move>& best_moves);
 
 		inline zobrist get_zobrist(void) const;
+		inline unsigned int get_depth(void) const;
+		inline int get_val(void) const;
+		inline hash_flag get_flag(void) const;
+		inline const std::vector<move>& get_best_moves(void) const;
 		int get_val(unsigned int depth, int alpha, int beta,
 			std::vector<move>& best_moves) const;
 
@@ -52,6 +52,26 @@ namespace checkers
 	{
 		return this->_zobrist;
 	}
+
+	inline unsigned int record::get_depth(void) const
+	{
+		return this->_depth;
+	}
+
+	inline int record::get_val(void) const
+	{
+		return this->_val;
+	}
+
+	inline record::hash_flag record::get_flag(void) const
+	{
+		return this->_flag;
+	}
+
+	inline const std::vector<move>& record::get_best_moves(void) const
+	{
+		return this->_best_moves;
+	}
 }
 
 #endif // __RECORD_I_HPP__
@@ -0,0 +1,482 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file retrograde.cpp
+ *  @brief Build endgame databases by retrograde analysis.
+ */
+
+extern "C"
+{
+	#include <pthread.h>
+}
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <stdexcept>
+#include "retrograde.hpp"
+#include "timeval.hpp"
+
+namespace checkers
+{
+	namespace
+	{
+		/// Value of an index whose position does not exist.
+		const uint8_t INVALID = 4;
+		/// Number of indexes a worker thread takes at a time.
+		const uint64_t CHUNK = 4096;
+	}
+
+	retrograde::retrograde(unsigned int threads, bool distances) :
+		_threads(threads > retrograde::max_threads ?
+			retrograde::max_threads : std::max(1U, threads)),
+		_distances(distances), _pieces(0), _slices(), _tables(),
+		_indexes(egdb::keys, -1),
+		_currents(0)
+	{
+	}
+
+	retrograde::~retrograde(void)
+	{
+	}
+
+	/**  Only the slices with pieces of both colors are solved, as a
+	 *   player without pieces has lost already.
+	 */
+	void retrograde::solve(unsigned int pieces, std::ostream& log)
+	{
+		if (pieces > egdb::max_pieces)
+		{
+			/// @throw std::invalid_argument when there are too
+			///  many pieces.
+			throw std::invalid_argument("Error (too many pieces for"
+				" endgame database)");
+		}
+
+		for (unsigned int n = 2; n <= pieces; ++n)
+		{
+			for (unsigned int men = 0; men <= n; ++men)
+			{
+				for (unsigned int black_men = 0; black_men <= men;
+					++black_men)
+				{
+					for (unsigned int black_kings = 0;
+						black_kings <= n - men; ++black_kings)
+					{
+						const egdb::slice slice =
+						{
+							black_men, black_kings,
+							men - black_men,
+							n - men - black_kings
+						};
+
+						if (slice.black_men + slice.black_kings &&
+							slice.white_men +
+							slice.white_kings &&
+							-1 == this->_indexes[
+								egdb::key(slice)])
+						{
+							this->solve(slice, log);
+						}
+					}
+				}
+			}
+		}
+		this->_pieces = std::max(this->_pieces, pieces);
+	}
+
+	void retrograde::save(const std::string& filename) const
+	{
+		egdb::save(filename, this->_pieces, this->_distances,
+			this->_slices, this->_tables);
+	}
+
+	void retrograde::solve(const egdb::slice& slice, std::ostream& log)
+	{
+		const struct timeval start = timeval::now();
+		unsigned int i;
+
+		this->_current[0] = slice;
+		this->_current[1] = slice.mirror();
+		this->_currents = slice == slice.mirror() ? 1 : 2;
+		for (i = 0; i < this->_currents; ++i)
+		{
+			this->_values[i].assign(egdb::size(this->_current[i]),
+				egdb::UNKNOWN);
+			this->_turns[i].assign(this->_distances ?
+				this->_values[i].size() : 0, egdb::no_distance);
+		}
+
+		unsigned int passes = 0;
+		work work;
+		work._retrograde = this;
+		work._measure = false;
+		work._distance = 0;
+		do
+		{
+			work._next = 0;
+			work._changes = 0;
+			++passes;
+			this->run(work);
+		}
+		while (work._changes);
+
+		if (this->_distances)
+		{
+			uint64_t decided = 0;
+			uint64_t found = 0;
+
+			for (i = 0; i < this->_currents; ++i)
+			{
+				const std::vector<uint8_t>& values = this->_values[i];
+
+				decided += std::count(values.begin(), values.end(),
+					uint8_t(egdb::WIN)) + std::count(values.begin(),
+					values.end(), uint8_t(egdb::LOSS));
+			}
+
+			// The distances of the slices solved before may be far,
+			// so a pass may find none.
+			work._measure = true;
+			for (; found < decided; ++work._distance)
+			{
+				if (work._distance > egdb::max_distance)
+				{
+					/// @throw std::runtime_error when a distance
+					///  does not fit in a byte.
+					throw std::runtime_error("Error (distance too"
+						" long for endgame database)");
+				}
+				work._next = 0;
+				work._changes = 0;
+				this->run(work);
+				found += work._changes;
+			}
+		}
+
+		for (i = 0; i < this->_currents; ++i)
+		{
+			const std::vector<uint8_t>& values = this->_values[i];
+			const uint64_t size = values.size();
+			std::vector<uint8_t> table(this->_distances ? size :
+				(size + 3) / 4, 0);
+			uint64_t counts[4] = { 0, 0, 0, 0 };
+			egdb::value value = egdb::UNKNOWN;
+			uint8_t distance = egdb::no_distance;
+			unsigned int longest = 0;
+
+			// The positions which do not exist take the value
+			// before them, which makes longer runs to compress.
+			for (uint64_t index = 0; index < size; ++index)
+			{
+				if (INVALID != values[index])
+				{
+					value = egdb::UNKNOWN == values[index] ?
+						egdb::DRAW : egdb::value(values[index]);
+					++counts[value];
+					if (this->_distances)
+					{
+						distance = this->_turns[i][index];
+						longest = egdb::DRAW == value ||
+							distance < longest ?
+							longest : distance;
+					}
+				}
+				if (this->_distances)
+				{
+					table[index] = distance;
+				}
+				else
+				{
+					egdb::set(table, index, value);
+				}
+			}
+			this->_indexes[egdb::key(this->_current[i])] =
+				int(this->_slices.size());
+			this->_slices.push_back(this->_current[i]);
+			this->_tables.push_back(std::vector<uint8_t>());
+			this->_tables.back().swap(table);
+			std::vector<uint8_t>().swap(this->_values[i]);
+			std::vector<uint8_t>().swap(this->_turns[i]);
+
+			const struct timeval time = timeval::now() - start;
+			log << std::setw(10) << egdb::name(this->_current[i])
+				<< std::setw(12) << size
+				<< std::setw(12) << counts[egdb::WIN]
+				<< std::setw(12) << counts[egdb::LOSS]
+				<< std::setw(12) << counts[egdb::DRAW]
+				<< std::setw(7) << passes
+				<< std::setw(6) << time.tv_sec << '.'
+				<< std::setw(3) << std::setfill('0')
+				<< time.tv_usec / 1000 << std::setfill(' ');
+			if (this->_distances)
+			{
+				log << std::setw(9) << longest;
+			}
+			log << '\n' << std::flush;
+		}
+		this->_currents = 0;
+	}
+
+	void retrograde::run(work& work)
+	{
+		if (1 == this->_threads)
+		{
+			retrograde::worker(&work);
+			return;
+		}
+
+		pthread_t tids[retrograde::max_threads];
+		unsigned int i;
+		int err;
+
+		for (i = 0; i < this->_threads; ++i)
+		{
+			if ((err = pthread_create(&tids[i], NULL,
+				&retrograde::worker, &work)) != 0)
+			{
+				while (i--)
+				{
+					pthread_join(tids[i], NULL);
+				}
+				/// @throw std::runtime_error when pthread_create()
+				///  failed.
+				throw std::runtime_error(std::string(
+					"pthread_create() failed: ") +
+					std::strerror(err));
+			}
+		}
+		for (i = 0; i < this->_threads; ++i)
+		{
+			pthread_join(tids[i], NULL);
+		}
+	}
+
+	void* retrograde::worker(void* arg)
+	{
+		work& work = *static_cast<retrograde::work*>(arg);
+		const retrograde& retrograde = *work._retrograde;
+		const uint64_t size = retrograde._values[0].size();
+		const uint64_t total = size + (2 == retrograde._currents ?
+			retrograde._values[1].size() : 0);
+		uint64_t changes = 0;
+		uint64_t begin;
+
+		while ((begin = __sync_fetch_and_add(&work._next, CHUNK)) <
+			total)
+		{
+			const uint64_t end = std::min(begin + CHUNK, total);
+
+			for (uint64_t n = begin; n < end; ++n)
+			{
+				const unsigned int i = n < size ? 0 : 1;
+				const uint64_t index = n < size ? n : n - size;
+				uint8_t& value = retrograde._values[i][index];
+
+				if (work._measure)
+				{
+					uint8_t& distance = retrograde._turns[i][index];
+
+					if ((egdb::WIN == value || egdb::LOSS == value) &&
+						egdb::no_distance == distance)
+					{
+						distance = retrograde.measure(i, index,
+							work._distance);
+						changes += egdb::no_distance != distance;
+					}
+				}
+				else if (egdb::UNKNOWN == value)
+				{
+					value = retrograde.solve(i, index);
+					changes += egdb::UNKNOWN != value;
+				}
+			}
+		}
+		__sync_fetch_and_add(&work._changes, changes);
+		return NULL;
+	}
+
+	/**  @return egdb::WIN, egdb::LOSS, egdb::UNKNOWN while neither is
+	 *   known yet, or INVALID.
+	 */
+	egdb::value retrograde::solve(unsigned int i, uint64_t index) const
+	{
+		uint32_t black;
+		uint32_t white;
+		uint32_t kings;
+
+		if (!egdb::position(this->_current[i], index, black, white,
+			kings))
+		{
+			return egdb::value(INVALID);
+		}
+
+		board board(bitboard(black), bitboard(white), bitboard(kings),
+			board::BLACK);
+		bool win = false;
+		bool loss = true;
+
+		this->search(board, bitboard(bitboard::EMPTY), win, loss);
+		return win ? egdb::WIN : loss ? egdb::LOSS : egdb::UNKNOWN;
+	}
+
+	/**  @param win Set true when a turn leads to a loss of the
+	 *   opponent.
+	 *  @param loss Set false when a turn does not lead to a win of the
+	 *   opponent.
+	 */
+	void retrograde::search(board& board, bitboard jumper, bool& win,
+		bool& loss) const
+	{
+		const std::vector<move> moves = jumper ?
+			board.generate_jumps(jumper) : board.generate_moves();
+
+		for (std::vector<move>::const_iterator pos = moves.begin();
+			!win && pos != moves.end(); ++pos)
+		{
+			if (board.make_move(*pos))
+			{
+				this->search(board, pos->get_dest(), win, loss);
+			}
+			else
+			{
+				unsigned int distance;
+				const egdb::value value = this->lookup(board,
+					distance);
+
+				win = egdb::LOSS == value;
+				loss = loss && egdb::WIN == value;
+			}
+			board.undo_move(*pos);
+		}
+	}
+
+	/**  A position is found at the pass of its distance, when all
+	 *   the turns are known to lead to the distances before it, for a
+	 *   lost position, or when a turn is known to lead to the distance
+	 *   just before it, for a won one.
+	 */
+	uint8_t retrograde::measure(unsigned int i, uint64_t index,
+		unsigned int distance) const
+	{
+		uint32_t black;
+		uint32_t white;
+		uint32_t kings;
+
+		egdb::position(this->_current[i], index, black, white, kings);
+
+		board board(bitboard(black), bitboard(white), bitboard(kings),
+			board::BLACK);
+		const bool win = egdb::WIN == this->_values[i][index];
+		unsigned int best = win ? egdb::no_distance : 0;
+		bool known = true;
+
+		this->measure(board, bitboard(bitboard::EMPTY), win, distance,
+			best, known);
+		assert(!known || egdb::no_distance == best ||
+			distance == best);
+		return known ? uint8_t(best) : egdb::no_distance;
+	}
+
+	/**  @param best The nearest distance after a turn to a loss of
+	 *   the opponent, plus 1, when @e win, otherwise the farthest.
+	 *  @param known Set false when a turn leads to a distance not
+	 *   known before @e distance, and @e board is lost.
+	 */
+	void retrograde::measure(board& board, bitboard jumper, bool win,
+		unsigned int distance, unsigned int& best, bool& known) const
+	{
+		const std::vector<move> moves = jumper ?
+			board.generate_jumps(jumper) : board.generate_moves();
+
+		for (std::vector<move>::const_iterator pos = moves.begin();
+			known && pos != moves.end(); ++pos)
+		{
+			if (board.make_move(*pos))
+			{
+				this->measure(board, pos->get_dest(), win, distance,
+					best, known);
+			}
+			else
+			{
+				unsigned int next;
+				const egdb::value value = this->lookup(board, next);
+
+				if (win)
+				{
+					best = egdb::LOSS == value && next < distance &&
+						next + 1 < best ? next + 1 : best;
+				}
+				else if (next < distance)
+				{
+					best = next + 1 > best ? next + 1 : best;
+				}
+				else
+				{
+					known = false;
+				}
+			}
+			board.undo_move(*pos);
+		}
+	}
+
+	/**  The slices being solved hold a byte a value, the others
+	 *   2 bits, or a byte a distance.
+	 */
+	egdb::value retrograde::lookup(const board& board,
+		unsigned int& distance) const
+	{
+		uint32_t black;
+		uint32_t white;
+		uint32_t kings;
+
+		egdb::orient(board, black, white, kings);
+		if (!black)
+		{
+			distance = 0;
+			return egdb::LOSS;
+		}
+
+		const egdb::slice slice = egdb::get_slice(black, white, kings);
+		const uint64_t index = egdb::index(slice, black, white, kings);
+		for (unsigned int i = 0; i < this->_currents; ++i)
+		{
+			if (slice == this->_current[i])
+			{
+				distance = this->_distances ?
+					this->_turns[i][index] : egdb::no_distance;
+				return egdb::value(this->_values[i][index]);
+			}
+		}
+
+		const int n = this->_indexes[egdb::key(slice)];
+		assert(n >= 0);
+		if (this->_distances)
+		{
+			distance = this->_tables[n][index];
+			return egdb::decode(this->_tables[n][index]);
+		}
+		distance = egdb::no_distance;
+		return egdb::get(this->_tables[n], index);
+	}
+}
+
+// End of file
@@ -0,0 +1,158 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file retrograde.hpp
+ *  @brief Build endgame databases by retrograde analysis.
+ */
+
+#ifndef __RETROGRADE_HPP__
+#define __RETROGRADE_HPP__
+
+extern "C"
+{
+	#include <stdint.h>
+}
+#include <ostream>
+#include <string>
+#include <vector>
+#include "board.hpp"
+#include "egdb.hpp"
+
+namespace checkers
+{
+	/** @class retrograde
+	 *  @brief Build the endgame databases of all the positions up to a
+	 *   number of pieces by retrograde analysis.
+	 *
+	 *   The slices are solved from the fewest pieces up, and for the
+	 *   same number of pieces from the fewest men up, so that captures
+	 *   and crownings lead into slices solved before.  The other moves
+	 *   lead from a slice into its mirror with the colors swapped, and
+	 *   the two are solved together.
+	 *
+	 *   A position is won when a turn leads to a position lost for the
+	 *   opponent, and lost when every turn leads to a position won for
+	 *   the opponent, or when there is no turn.  The passes over the
+	 *   two slices repeat until they find nothing new, and the
+	 *   positions left are drawn.
+	 *
+	 *   Each pass is shared out to worker threads by chunks of indexes.
+	 *   A value only ever changes once, from unknown to won or lost, so
+	 *   the threads update the slices in place.
+	 *
+	 *   The distances, when asked for, are measured by more passes
+	 *   once the values are known.  The pass n finds the positions n
+	 *   turns from the end of the game, from the distances found by
+	 *   the passes before it only.
+	 */
+	class retrograde
+	{
+	public:
+		/// Measure the distances too when @e distances.
+		explicit retrograde(unsigned int threads = 1,
+			bool distances = false);
+		~retrograde(void);
+
+		/** @brief Solve all the slices up to @e pieces, showing each
+		 *   on @e log.
+		 */
+		void solve(unsigned int pieces, std::ostream& log);
+		/// Write the databases solved to @e filename.
+		void save(const std::string& filename) const;
+
+		/// Maximum number of worker threads.
+		static const unsigned int max_threads = 64;
+
+	private:
+		/// A pass over the slices being solved.
+		struct work
+		{
+			const retrograde* _retrograde;
+			/// Index of the next chunk to take.
+			volatile uint64_t _next;
+			/// Number of the values found in the pass.
+			volatile uint64_t _changes;
+			/// Whether the pass measures distances.
+			bool _measure;
+			/// The distance measured by the pass.
+			unsigned int _distance;
+		};
+
+		/// Solve @e slice together with its mirror.
+		void solve(const egdb::slice& slice, std::ostream& log);
+		/// Share out the pass @e work to the worker threads.
+		void run(work& work);
+		static void* worker(void* arg);
+
+		/// Find the value of @e index of the slice @e i being solved.
+		egdb::value solve(unsigned int i, uint64_t index) const;
+		/** @brief Look through the turns of the player to move, from
+		 *   the piece @e jumper jumping once more if not empty.
+		 */
+		void search(board& board, bitboard jumper, bool& win,
+			bool& loss) const;
+		/** @brief Find whether @e index of the slice @e i being solved
+		 *   is @e distance turns from the end of the game.
+		 *  @return @e distance, or egdb::no_distance.
+		 */
+		uint8_t measure(unsigned int i, uint64_t index,
+			unsigned int distance) const;
+		/** @brief Look through the turns of the player to move, from
+		 *   the piece @e jumper jumping once more if not empty, for
+		 *   the distances below @e distance.
+		 */
+		void measure(board& board, bitboard jumper, bool win,
+			unsigned int distance, unsigned int& best,
+			bool& known) const;
+		/** @brief Get the value of @e board from the tables, and its
+		 *   distance, egdb::no_distance when not known.
+		 */
+		egdb::value lookup(const board& board,
+			unsigned int& distance) const;
+
+		unsigned int _threads;
+		/// Whether the distances are measured.
+		bool _distances;
+		/// Maximum number of pieces of the slices solved.
+		unsigned int _pieces;
+		/// The slices solved, in order.
+		std::vector<egdb::slice> _slices;
+		/** @brief The values of the slices solved, 2 bits each, or
+		 *   the distances, a byte each.
+		 */
+		std::vector<std::vector<uint8_t> > _tables;
+		/// Index of each slice in _slices, or -1 when not solved.
+		std::vector<int> _indexes;
+
+		/// The slice and its mirror being solved.
+		egdb::slice _current[2];
+		/// Number of the slices being solved, 1 when symmetric.
+		unsigned int _currents;
+		/// The values of the slices being solved, a byte each.
+		mutable std::vector<uint8_t> _values[2];
+		/// The distances of the slices being solved.
+		mutable std::vector<uint8_t> _turns[2];
+	};
+}
+
+#endif // __RETROGRADE_HPP__
+// End of file
@@ -0,0 +1,221 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file stats.cpp
+ *  @brief Search statistics.
+ */
+
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include "stats.hpp"
+
+namespace checkers
+{
+	namespace
+	{
+		/// Percentage of @e part in @e whole.
+		inline double percent(long unsigned int part,
+			long unsigned int whole)
+		{
+			return whole ? 100.0 * part / whole : 0.0;
+		}
+	}
+
+	void stats::reset(void)
+	{
+		for (unsigned int i = 0; i < COUNTERS; ++i)
+		{
+			stats::_counters[i] = 0;
+		}
+		stats::_iteration_nodes.clear();
+		stats::_time.tv_sec = 0;
+		stats::_time.tv_usec = 0;
+	}
+
+	/** @param depth The depth of the finished iteration.
+	 *  @param nodes Nodes searched by the iteration.
+	 *  @param time Time spent by the iteration.
+	 */
+	void stats::iteration(unsigned int depth, long unsigned int nodes,
+		struct timeval time)
+	{
+		if (stats::_iteration_nodes.size() <= depth)
+		{
+			stats::_iteration_nodes.resize(depth + 1, 0);
+		}
+		stats::_iteration_nodes[depth] = nodes;
+		stats::_time += time;
+	}
+
+	std::string stats::report(void)
+	{
+		std::ostringstream stream;
+		const long unsigned int nodes = stats::get(NODES);
+		long unsigned int cutoffs = 0;
+		unsigned int i;
+
+		for (i = BETA_CUTOFFS; i <= BETA_CUTOFFS_LAST; ++i)
+		{
+			cutoffs += stats::_counters[i];
+		}
+
+		stream.setf(std::ios::fixed);
+		stream << std::setprecision(1);
+#ifdef NSTATS
+		stream << "  (statistics compiled out with NSTATS)\n";
+#endif
+		stream << "  nodes             " << std::setw(11) << nodes <<
+			"   nps " << long(stats::nodes_per_second()) <<
+			"   time " << stats::_time.tv_sec << '.' <<
+			std::setw(3) << std::setfill('0') <<
+			(stats::_time.tv_usec / 1000) << std::setfill(' ') <<
+			'\n';
+		stream << "  quiescence nodes  " << std::setw(11) <<
+			stats::get(QUIESCENCE_NODES) << "   " <<
+			percent(stats::get(QUIESCENCE_NODES), nodes) << "%\n";
+		stream << "  hash probes       " << std::setw(11) <<
+			stats::get(HASH_PROBES) << "   hits " <<
+			percent(stats::get(HASH_HITS),
+				stats::get(HASH_PROBES)) <<
+			"%   cutoffs " << percent(stats::get(HASH_CUTOFFS),
+				stats::get(HASH_PROBES)) << "%\n";
+		stream << "  hash stores       " << std::setw(11) <<
+			stats::get(HASH_STORES) << "   overwrites " <<
+			percent(stats::get(HASH_OVERWRITES),
+				stats::get(HASH_STORES)) << "%\n";
+		stream << "  eval cache probes " << std::setw(11) <<
+			stats::get(EVAL_CACHE_PROBES) << "   hits " <<
+			percent(stats::get(EVAL_CACHE_HITS),
+				stats::get(EVAL_CACHE_PROBES)) << "%\n";
+		stream << "  evaluations       " << std::setw(11) <<
+			stats::get(EVALUATIONS) << "   lazy " <<
+			percent(stats::get(LAZY_EXITS),
+				stats::get(EVALUATIONS)) << "%\n";
+		stream << "  egdb probes       " << std::setw(11) <<
+			stats::get(EGDB_PROBES) << "   hits " <<
+			percent(stats::get(EGDB_HITS),
+				stats::get(EGDB_PROBES)) << "%   loads " <<
+			stats::get(EGDB_LOADS) << '\n';
+		stream << "  beta cutoffs      " << std::setw(11) << cutoffs <<
+			"  ";
+		for (i = BETA_CUTOFFS; i <= BETA_CUTOFFS_LAST; ++i)
+		{
+			stream << " #" << (i - BETA_CUTOFFS + 1) <<
+				(BETA_CUTOFFS_LAST == i ? "+ " : " ") <<
+				percent(stats::_counters[i], cutoffs) << '%';
+		}
+		stream << '\n';
+		stream << std::setprecision(2);
+		stream << "  branching factor  " << std::setw(11) <<
+			stats::branching_factor() << '\n';
+		stream << "  moves/generation  " << std::setw(11) <<
+			(stats::get(MOVE_GENERATIONS) ?
+			 double(stats::get(GENERATED_MOVES)) /
+			 stats::get(MOVE_GENERATIONS) : 0.0) << '\n';
+
+		return stream.str();
+	}
+
+	std::string stats::report_raw(void)
+	{
+		std::ostringstream stream;
+
+		stream.setf(std::ios::fixed);
+		stream << std::setprecision(3);
+		for (unsigned int i = 0; i < COUNTERS; ++i)
+		{
+			stream << stats::_names[i];
+			if (i >= BETA_CUTOFFS)
+			{
+				stream << '_' << (i - BETA_CUTOFFS + 1);
+			}
+			stream << ' ' << stats::_counters[i] << '\n';
+		}
+		stream << "time " << (stats::_time.tv_sec +
+			stats::_time.tv_usec / 1e6) << '\n';
+		stream << "nps " << long(stats::nodes_per_second()) << '\n';
+		stream << "branching_factor " << stats::branching_factor() <<
+			'\n';
+
+		return stream.str();
+	}
+
+	// ================================================================
+
+	/** @return The ratio of nodes of the last two iterations, which are
+	 *   not cut short by timeout.
+	 */
+	double stats::branching_factor(void)
+	{
+		std::vector<long unsigned int>::size_type i =
+			stats::_iteration_nodes.size();
+
+		while (i >= 2)
+		{
+			--i;
+			if (stats::_iteration_nodes[i] &&
+				stats::_iteration_nodes[i - 1])
+			{
+				return double(stats::_iteration_nodes[i]) /
+					stats::_iteration_nodes[i - 1];
+			}
+		}
+		return 0.0;
+	}
+
+	double stats::nodes_per_second(void)
+	{
+		const double seconds = stats::_time.tv_sec +
+			stats::_time.tv_usec / 1e6;
+
+		return seconds > 0 ? stats::get(NODES) / seconds : 0.0;
+	}
+
+	long unsigned int stats::_counters[stats::COUNTERS] = { 0 };
+	const char* const stats::_names[stats::COUNTERS] =
+	{
+		"nodes",
+		"quiescence_nodes",
+		"hash_probes",
+		"hash_hits",
+		"hash_cutoffs",
+		"hash_stores",
+		"hash_overwrites",
+		"eval_cache_probes",
+		"eval_cache_hits",
+		"evaluations",
+		"lazy_exits",
+		"egdb_probes",
+		"egdb_hits",
+		"egdb_loads",
+		"move_generations",
+		"generated_moves",
+		"beta_cutoffs", "beta_cutoffs", "beta_cutoffs",
+		"beta_cutoffs", "beta_cutoffs", "beta_cutoffs",
+		"beta_cutoffs", "beta_cutoffs"
+	};
+	std::vector<long unsigned int> stats::_iteration_nodes;
+	struct timeval stats::_time = { 0, 0 };
+}
+
+// End of file
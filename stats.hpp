@@ -0,0 +1,123 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file stats.hpp
+ *  @brief Search statistics.
+ */
+
+#ifndef __STATS_HPP__
+#define __STATS_HPP__
+
+#include <string>
+#include <vector>
+#include "timeval.hpp"
+
+namespace checkers
+{
+	/** @class stats
+	 *  @brief Counters of the last search, to tune the engine from data.
+	 *
+	 *   The counters cost an increment each in the innermost loops, so
+	 *   they are compiled out when NSTATS is defined, the same way as
+	 *   assert() with NDEBUG.  The increments are not atomic, so the
+	 *   counters are only added to by the search, which runs in one
+	 *   thread, never by board or the threaded perft and MCTS.
+	 */
+	class stats
+	{
+	public:
+		enum counter
+		{
+			/// Nodes visited by the search.
+			NODES = 0,
+			/// Nodes beyond the nominal depth of the iteration.
+			QUIESCENCE_NODES,
+			/// Lookups in the hash table.
+			HASH_PROBES,
+			/// Lookups finding a record of the same position.
+			HASH_HITS,
+			/// Lookups returning a value which ends the node.
+			HASH_CUTOFFS,
+			/// Records stored into the hash table.
+			HASH_STORES,
+			/// Records replacing a record of another position.
+			HASH_OVERWRITES,
+			/// Lookups in the evaluation cache.
+			EVAL_CACHE_PROBES,
+			/// Lookups finding the value of the same position.
+			EVAL_CACHE_HITS,
+			/// Evaluations of leaves not found in the cache.
+			EVALUATIONS,
+			/// Evaluations returning a bound without the movers.
+			LAZY_EXITS,
+			/// Lookups in the endgame databases.
+			EGDB_PROBES,
+			/// Lookups finding the position in the databases.
+			EGDB_HITS,
+			/// Blocks of the databases decompressed into the cache.
+			EGDB_LOADS,
+			/// Move generations of the search nodes.
+			MOVE_GENERATIONS,
+			/// Moves generated at the search nodes.
+			GENERATED_MOVES,
+			/// Beta cutoffs by the first move, the second move...
+			BETA_CUTOFFS,
+			/// The last slot counts all the later moves.
+			BETA_CUTOFFS_LAST = BETA_CUTOFFS + 7,
+			/// Number of counters.
+			COUNTERS
+		};
+
+		/// Clear all the counters.
+		static void reset(void);
+		/// Add @e n to @e counter.
+		inline static void add(counter counter,
+			long unsigned int n = 1);
+		/// Count a beta cutoff by the move at @e index.
+		inline static void beta_cutoff(unsigned int index);
+		/// Record the nodes of a finished iteration.
+		static void iteration(unsigned int depth,
+			long unsigned int nodes, struct timeval time);
+
+		inline static long unsigned int get(counter counter);
+
+		/// Statistics block for human reading.
+		static std::string report(void);
+		/// Statistics as lines of ``name value'' pairs.
+		static std::string report_raw(void);
+
+	private:
+		/// Effective branching factor of the last iterations.
+		static double branching_factor(void);
+		/// Nodes per second of all the iterations.
+		static double nodes_per_second(void);
+
+		static long unsigned int _counters[COUNTERS];
+		static const char* const _names[COUNTERS];
+		static std::vector<long unsigned int> _iteration_nodes;
+		static struct timeval _time;
+	};
+}
+
+#include "stats_i.hpp"
+#endif // __STATS_HPP__
+// End of file
@@ -0,0 +1,55 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file stats_i.hpp
+ *  @brief Search statistics.
+ */
+
+#ifndef __STATS_I_HPP__
+#define __STATS_I_HPP__
+
+namespace checkers
+{
+	inline void stats::add(counter counter, long unsigned int n)
+	{
+#ifndef NSTATS
+		stats::_counters[counter] += n;
+#else
+		(void)counter;
+		(void)n;
+#endif
+	}
+
+	inline void stats::beta_cutoff(unsigned int index)
+	{
+		stats::add(index < BETA_CUTOFFS_LAST - BETA_CUTOFFS ?
+			counter(BETA_CUTOFFS + index) : BETA_CUTOFFS_LAST);
+	}
+
+	inline long unsigned int stats::get(counter counter)
+	{
+		return stats::_counters[counter];
+	}
+}
+
+#endif // __STATS_I_HPP__
+// End of file
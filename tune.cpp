@@ -0,0 +1,183 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file tune.cpp
+ *  @brief Tune the evaluation weights by a dataset of positions and results.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include "evaluate.hpp"
+#include "timeval.hpp"
+#include "tuner.hpp"
+
+void usage(void)
+{
+	std::cerr
+		<< "Usage: tune [--threads N] [--iterations N] [--rate R]\n"
+		<< "            [--weights FILE] [--output FILE] DATASET...\n"
+		<< "\n"
+		<< "Each line of a DATASET is a position in FEN and the result"
+		<< " of its game,\n"
+		<< "1-0, 0-1 or 1/2-1/2 as in PDN, or 1, 0 and 0.5, for Black,"
+		<< " or the\n"
+		<< "DATASET is a file of games in PDN, or a packed dataset.\n"
+		<< "The tuning begins from the weights of FILE, or the default"
+		<< " weights, and\n"
+		<< "the tuned weights are written to the output FILE for the"
+		<< " engine command\n"
+		<< "``weights FILE'', or shown.\n"
+		<< std::flush;
+}
+
+/// Seconds since @e start.
+double since(const struct timeval& start)
+{
+	const struct timeval now = checkers::timeval::now();
+
+	return double(now.tv_sec - start.tv_sec) +
+		double(now.tv_usec - start.tv_usec) / 1000000.0;
+}
+
+int main(int argc, char* argv[])
+{
+	try
+	{
+		std::vector<std::string> datasets;
+		std::string weights;
+		std::string output;
+		unsigned int threads = 1;
+		unsigned int iterations = 1000;
+		double rate = 1.0;
+		int i = 0;
+
+		while (++i < argc)
+		{
+			const std::string arg(argv[i]);
+
+			if (("--threads" == arg || "--iterations" == arg ||
+				"--rate" == arg || "--weights" == arg ||
+				"--output" == arg) && i + 1 >= argc)
+			{
+				usage();
+				std::exit(255);
+			}
+			if ("--threads" == arg)
+			{
+				threads = std::strtoul(argv[++i], NULL, 10);
+			}
+			else if ("--iterations" == arg)
+			{
+				iterations = std::strtoul(argv[++i], NULL, 10);
+			}
+			else if ("--rate" == arg)
+			{
+				rate = std::strtod(argv[++i], NULL);
+			}
+			else if ("--weights" == arg)
+			{
+				weights = argv[++i];
+			}
+			else if ("--output" == arg)
+			{
+				output = argv[++i];
+			}
+			else if ('-' == arg[0])
+			{
+				usage();
+				std::exit(255);
+			}
+			else
+			{
+				datasets.push_back(arg);
+			}
+		}
+		if (datasets.empty() || rate <= 0.0)
+		{
+			usage();
+			std::exit(255);
+		}
+
+		if (!weights.empty())
+		{
+			checkers::evaluate::load_weights(weights);
+		}
+
+		checkers::tuner tuner(threads);
+		struct timeval start = checkers::timeval::now();
+		for (std::vector<std::string>::const_iterator pos =
+			datasets.begin(); pos != datasets.end(); ++pos)
+		{
+			tuner.load(*pos, std::cerr);
+		}
+		if (0 == tuner.size())
+		{
+			std::cerr << "Error: No position to tune" << std::endl;
+			std::exit(255);
+		}
+		std::cout << "positions " << tuner.size() << ", skipped "
+			<< tuner.skipped() << ", read in "
+			<< since(start) << " s\n";
+
+		std::cout << std::setprecision(8);
+		std::cout << "scale " << tuner.fit_scale() << '\n';
+		std::cout << "error " << tuner.error() << '\n' << std::flush;
+
+		start = checkers::timeval::now();
+		for (unsigned int done = 0; done < iterations; )
+		{
+			const unsigned int steps = std::min(100U,
+				iterations - done);
+			const double error = tuner.descend(steps, rate);
+
+			done += steps;
+			std::cout << "iteration " << done << " error " << error
+				<< '\n' << std::flush;
+		}
+		std::cout << "polished error " << tuner.polish() << ", tuned in "
+			<< since(start) << " s\n";
+
+		tuner.apply();
+		if (output.empty())
+		{
+			std::cout << checkers::evaluate::report_weights()
+				<< std::flush;
+		}
+		else
+		{
+			checkers::evaluate::save_weights(output);
+		}
+	}
+	catch (std::exception& e)
+	{
+		std::cerr << "Fatal error: " << e.what() << std::endl;
+		std::exit(255);
+	}
+
+	return 0;
+}
+
+// End of file
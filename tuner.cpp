@@ -0,0 +1,377 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file tuner.cpp
+ *  @brief Tuning of the evaluation weights by the results of games.
+ */
+
+extern "C"
+{
+	#include <pthread.h>
+}
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include "dataset.hpp"
+#include "evaluate.hpp"
+#include "tuner.hpp"
+
+namespace checkers
+{
+	namespace
+	{
+		/// The names of the weights, in the order of the features.
+		const char* const NAMES[tuner::FEATURES] =
+		{
+			"man", "king", "mover", "kings_row", "edge"
+		};
+
+		/// Round @e value to the nearest integer.
+		inline int nearest(double value)
+		{
+			return int(value < 0.0 ? value - 0.5 : value + 0.5);
+		}
+	}
+
+	tuner::tuner(unsigned int threads) :
+		_rows(), _skipped(0),
+		_threads(threads > tuner::max_threads ? tuner::max_threads :
+			std::max(1U, threads)),
+		_scale(1.0), _steps(0)
+	{
+		const evaluate::weights& weights = evaluate::get_weights();
+
+		this->_weights[0] = weights.man;
+		this->_weights[1] = weights.king;
+		this->_weights[2] = weights.mover;
+		this->_weights[3] = weights.kings_row;
+		this->_weights[4] = weights.edge;
+		std::fill(this->_first, this->_first + tuner::FEATURES, 0.0);
+		std::fill(this->_second, this->_second + tuner::FEATURES, 0.0);
+	}
+
+	/**  The file is read by dataset, lines of FEN and the result or
+	 *   games in PDN.  Positions of an unknown result are skipped, and
+	 *   so are the lines and games which cannot be read, each shown on
+	 *   @e log.
+	 */
+	void tuner::load(const std::string& filename, std::ostream& log)
+	{
+		dataset dataset(filename);
+		dataset::sample sample;
+
+		while (dataset.next(sample))
+		{
+			const board board = dataset::to_board(sample);
+			const int sign = board.is_black_to_move() ? 1 : -1;
+			row row;
+
+			if (sample.result < 0 || (board.is_black_to_move() ?
+				board.get_black_jumpers() ||
+				!board.get_black_movers() :
+				board.get_white_jumpers() ||
+				!board.get_white_movers()))
+			{
+				++this->_skipped;
+				continue;
+			}
+			row._result = uint8_t(sample.result);
+			row._features[0] = int8_t(sign * evaluate::men(board));
+			row._features[1] = int8_t(sign * evaluate::kings(board));
+			row._features[2] = int8_t(sign * evaluate::movers(board));
+			row._features[3] = int8_t(sign *
+				evaluate::kings_row(board));
+			row._features[4] = int8_t(sign * evaluate::edges(board));
+			this->_rows.push_back(row);
+		}
+		for (std::vector<dataset::error>::const_iterator error =
+			dataset.get_errors().begin();
+			error != dataset.get_errors().end(); ++error)
+		{
+			log << filename << ':' << error->line << ": "
+				<< error->message << '\n';
+		}
+		this->_skipped += dataset.get_errors().size();
+	}
+
+	/**  A golden section search over the logarithm of the scale.
+	 *  @return The scale.
+	 */
+	double tuner::fit_scale(void)
+	{
+		const double ratio = (std::sqrt(5.0) - 1.0) / 2.0;
+		double low = -6.0;
+		double high = 0.0;
+		double x1 = high - ratio * (high - low);
+		double x2 = low + ratio * (high - low);
+		double e1;
+		double e2;
+
+		this->_scale = std::pow(10.0, x1);
+		e1 = this->error();
+		this->_scale = std::pow(10.0, x2);
+		e2 = this->error();
+		for (unsigned int i = 0; i < 40; ++i)
+		{
+			if (e1 < e2)
+			{
+				high = x2;
+				x2 = x1;
+				e2 = e1;
+				x1 = high - ratio * (high - low);
+				this->_scale = std::pow(10.0, x1);
+				e1 = this->error();
+			}
+			else
+			{
+				low = x1;
+				x1 = x2;
+				e1 = e2;
+				x2 = low + ratio * (high - low);
+				this->_scale = std::pow(10.0, x2);
+				e2 = this->error();
+			}
+		}
+		this->_scale = std::pow(10.0, (low + high) / 2.0);
+		return this->_scale;
+	}
+
+	double tuner::error(void)
+	{
+		return this->run(this->_weights, NULL);
+	}
+
+	/**  The steps are by Adam, which keeps a moving average of the
+	 *   gradient and of its square for each weight, so each weight
+	 *   moves by about @e rate whatever the size of its feature.  The
+	 *   averages carry over to the next call.
+	 *  @return The error after the last step.
+	 */
+	double tuner::descend(unsigned int iterations, double rate)
+	{
+		const double beta1 = 0.9;
+		const double beta2 = 0.999;
+		double gradient[tuner::FEATURES];
+
+		for (unsigned int i = 0; i < iterations; ++i)
+		{
+			this->run(this->_weights, gradient);
+			++this->_steps;
+
+			const double correct1 = 1.0 - std::pow(beta1,
+				double(this->_steps));
+			const double correct2 = 1.0 - std::pow(beta2,
+				double(this->_steps));
+			// The man is the unit and stays.
+			for (unsigned int j = 1; j < tuner::FEATURES; ++j)
+			{
+				this->_first[j] = beta1 * this->_first[j] +
+					(1.0 - beta1) * gradient[j];
+				this->_second[j] = beta2 * this->_second[j] +
+					(1.0 - beta2) * gradient[j] * gradient[j];
+
+				const double deviation = std::sqrt(
+					this->_second[j] / correct2);
+				if (deviation > 0.0)
+				{
+					this->_weights[j] -= rate *
+						this->_first[j] / correct1 /
+						deviation;
+				}
+			}
+		}
+		return this->error();
+	}
+
+	/**  The weights are rounded, then each in turn is stepped up or
+	 *   down by 1 for as long as the error falls, until no step helps.
+	 *  @return The error of the rounded weights.
+	 */
+	double tuner::polish(void)
+	{
+		for (unsigned int j = 0; j < tuner::FEATURES; ++j)
+		{
+			this->_weights[j] = nearest(this->_weights[j]);
+		}
+
+		double best = this->error();
+		bool improved = true;
+		while (improved)
+		{
+			improved = false;
+			for (unsigned int j = 1; j < tuner::FEATURES; ++j)
+			{
+				for (int step = 1; step >= -1; step -= 2)
+				{
+					double error;
+
+					this->_weights[j] += step;
+					while ((error = this->error()) < best)
+					{
+						best = error;
+						improved = true;
+						this->_weights[j] += step;
+					}
+					this->_weights[j] -= step;
+				}
+			}
+		}
+		return best;
+	}
+
+	void tuner::apply(void) const
+	{
+		for (unsigned int j = 0; j < tuner::FEATURES; ++j)
+		{
+			evaluate::set_weight(NAMES[j], nearest(this->_weights[j]));
+		}
+	}
+
+	std::string tuner::report(void) const
+	{
+		std::ostringstream report;
+
+		for (unsigned int j = 0; j < tuner::FEATURES; ++j)
+		{
+			report << NAMES[j] << ' ' << this->_weights[j] << '\n';
+		}
+		return report.str();
+	}
+
+	/**  The matrix is cut into a slice for each thread.
+	 *  @return The mean square error.
+	 */
+	double tuner::run(const double* weights, double* gradient)
+	{
+		const size_t size = this->_rows.size();
+		slice slices[tuner::max_threads];
+		unsigned int i;
+
+		if (0 == size)
+		{
+			/// @throw std::logic_error when there is no position.
+			throw std::logic_error("Error (no position to tune)");
+		}
+		for (i = 0; i < this->_threads; ++i)
+		{
+			slices[i]._tuner = this;
+			slices[i]._weights = weights;
+			slices[i]._begin = size * i / this->_threads;
+			slices[i]._end = size * (i + 1) / this->_threads;
+			slices[i]._gradient_wanted = (NULL != gradient);
+		}
+
+		if (1 == this->_threads)
+		{
+			tuner::worker(&slices[0]);
+		}
+		else
+		{
+			pthread_t tids[tuner::max_threads];
+			int err;
+
+			for (i = 0; i < this->_threads; ++i)
+			{
+				if ((err = pthread_create(&tids[i], NULL,
+					&tuner::worker, &slices[i])) != 0)
+				{
+					while (i--)
+					{
+						pthread_join(tids[i], NULL);
+					}
+					/// @throw std::runtime_error when
+					///  pthread_create() failed.
+					throw std::runtime_error(
+						std::string("pthread_create() failed: ")
+						+ std::strerror(err));
+				}
+			}
+			for (i = 0; i < this->_threads; ++i)
+			{
+				pthread_join(tids[i], NULL);
+			}
+		}
+
+		double error = 0.0;
+		if (gradient)
+		{
+			std::fill(gradient, gradient + tuner::FEATURES, 0.0);
+		}
+		for (i = 0; i < this->_threads; ++i)
+		{
+			error += slices[i]._error;
+			for (unsigned int j = 0; gradient && j < tuner::FEATURES;
+				++j)
+			{
+				gradient[j] += slices[i]._gradient[j] / size;
+			}
+		}
+		return error / size;
+	}
+
+	/**  The sums are kept in locals and written to the slice at the
+	 *   end, as the features, of a char type, may alias the slice.
+	 */
+	void* tuner::worker(void* arg)
+	{
+		slice& slice = *static_cast<tuner::slice*>(arg);
+		const tuner& tuner = *slice._tuner;
+		const bool gradient_wanted = slice._gradient_wanted;
+		const double scale = tuner._scale;
+		double weights[tuner::FEATURES];
+		double gradient[tuner::FEATURES];
+		double error = 0.0;
+
+		std::copy(slice._weights, slice._weights + tuner::FEATURES,
+			weights);
+		std::fill(gradient, gradient + tuner::FEATURES, 0.0);
+		for (size_t i = slice._begin; i < slice._end; ++i)
+		{
+			const row& row = tuner._rows[i];
+			double value = 0.0;
+
+			for (unsigned int j = 0; j < tuner::FEATURES; ++j)
+			{
+				value += weights[j] * row._features[j];
+			}
+
+			const double expected = tuner.sigmoid(value);
+			const double delta = expected - 0.5 * row._result;
+			error += delta * delta;
+			if (gradient_wanted)
+			{
+				const double slope = 2.0 * delta * expected *
+					(1.0 - expected) * scale;
+				for (unsigned int j = 0; j < tuner::FEATURES; ++j)
+				{
+					gradient[j] += slope * row._features[j];
+				}
+			}
+		}
+		slice._error = error;
+		std::copy(gradient, gradient + tuner::FEATURES, slice._gradient);
+		return NULL;
+	}
+}
+
+// End of file
@@ -0,0 +1,147 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file tuner.hpp
+ *  @brief Tuning of the evaluation weights by the results of games.
+ */
+
+#ifndef __TUNER_HPP__
+#define __TUNER_HPP__
+
+extern "C"
+{
+	#include <stddef.h>
+	#include <stdint.h>
+}
+#include <ostream>
+#include <string>
+#include <vector>
+#include "board.hpp"
+
+namespace checkers
+{
+	/** @class tuner
+	 *  @brief Tune the weights of the linear evaluation to predict the
+	 *   results of the games that positions are taken from.
+	 *
+	 *   The error of a set of weights is the mean square distance
+	 *   between the result of each position, 1 for a win of Black, 0.5
+	 *   for a draw and 0 for a loss, and the sigmoid of its value.  The
+	 *   scale of the sigmoid is fitted to the weights to begin with, and
+	 *   stays fixed afterwards.
+	 *
+	 *   The terms of the evaluation are counted once for each position
+	 *   into a matrix of small integers, so a pass over millions of
+	 *   positions only multiplies and adds.  The passes are shared out
+	 *   to worker threads in slices of the matrix.
+	 *
+	 *   The weight of a man is the unit and does not change, the others
+	 *   are tuned by gradient descent and then polished by steps of 1.
+	 */
+	class tuner
+	{
+	public:
+		explicit tuner(unsigned int threads = 1);
+
+		/** @brief Add the positions of @e filename, a line of FEN
+		 *   and the result each, or games in PDN, and show the lines
+		 *   and games which cannot be read on @e log.
+		 */
+		void load(const std::string& filename, std::ostream& log);
+		/// Get the number of positions.
+		inline size_t size(void) const;
+		/** @brief Get the number of positions, lines and games
+		 *   skipped while loading.
+		 */
+		inline size_t skipped(void) const;
+
+		/// Fit the scale of the sigmoid to the current weights.
+		double fit_scale(void);
+		/// Get the error of the current weights.
+		double error(void);
+		/** @brief Move the weights along the gradient of the error
+		 *   for @e iterations steps of about @e rate each.
+		 */
+		double descend(unsigned int iterations, double rate);
+		/// Step the weights by 1 while the error falls.
+		double polish(void);
+
+		/// Set the evaluation weights to the tuned ones.
+		void apply(void) const;
+		/// Show the weights being tuned.
+		std::string report(void) const;
+
+		/// Number of the terms of the evaluation.
+		static const unsigned int FEATURES = 5;
+		/// Maximum number of worker threads.
+		static const unsigned int max_threads = 64;
+
+	private:
+		/** @brief The terms of a position for Black, and the result
+		 *   in half points for Black.
+		 */
+		struct row
+		{
+			int8_t _features[FEATURES];
+			uint8_t _result;
+		};
+
+		/** @brief A slice of the matrix for a worker thread, on cache
+		 *   lines of its own so that the threads share none.
+		 */
+		struct slice
+		{
+			const tuner* _tuner;
+			const double* _weights;
+			size_t _begin;
+			size_t _end;
+			/// Whether to sum the gradient too.
+			bool _gradient_wanted;
+			double _error;
+			double _gradient[FEATURES];
+		} __attribute__((aligned(64)));
+
+		/// The sigmoid of @e value, the expected result for Black.
+		inline double sigmoid(double value) const;
+
+		/** @brief Get the error of @e weights, and its gradient into
+		 *   @e gradient when not NULL.
+		 */
+		double run(const double* weights, double* gradient);
+		static void* worker(void* arg);
+
+		std::vector<row> _rows;
+		size_t _skipped;
+		unsigned int _threads;
+		double _scale;
+		double _weights[FEATURES];
+		/// Moving averages of the gradient and of its square.
+		double _first[FEATURES];
+		double _second[FEATURES];
+		/// Number of the steps of descend() so far.
+		unsigned int _steps;
+	};
+}
+
+#include "tuner_i.hpp"
+#endif // __TUNER_HPP__
+// End of file
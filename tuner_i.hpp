@@ -0,0 +1,55 @@
+/* $Id$
+
+   This file is a part of ponder, a English/American checkers game.
+
+   Copyright (c) 2026 Quux Information.
+                     Gong Jie <neo@quux.me>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; see the file COPYING.  If not, write to
+   the Free Software Foundation, Inc., 51 Franklin Steet, Fifth Floor,
+   Boston, MA 02110-1301, USA.
+ */
+/** @file tuner_i.hpp
+ *  @brief Tuning of the evaluation weights by the results of games.
+ */
+
+#ifndef __TUNER_I_HPP__
+#define __TUNER_I_HPP__
+
+#include <cmath>
+
+namespace checkers
+{
+	inline size_t tuner::size(void) const
+	{
+		return this->_rows.size();
+	}
+
+	/**  Positions are skipped when the player to move has to jump, as
+	 *   the value of such a position is not quiet, or when the game is
+	 *   over.
+	 */
+	inline size_t tuner::skipped(void) const
+	{
+		return this->_skipped;
+	}
+
+	inline double tuner::sigmoid(double value) const
+	{
+		return 1.0 / (1.0 + std::exp(-this->_scale * value));
+	}
+}
+
+#endif // __TUNER_I_HPP__
+// End of file